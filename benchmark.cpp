@@ -0,0 +1,383 @@
+// benchmark.cpp
+// ---------------------------------------------------------------
+// Micro and throughput benchmarks for every generator and primality
+// path in the repo, so a change can be checked for speed‑ups (or
+// regressions) instead of guessed at.
+//
+//   primality  isPrime64 / bitmap / trial division / isPrimeBatch
+//              at several magnitudes                  (candidates/s)
+//   rain       rainWorker across thread counts         (hops/s)
+//   logging    the same walk with no log, text log and binary journal
+//   sampling   rank/select: k‑th prime, next / previous prime (primes/s)
+//   codes      every CodeEngine style for letters, digits and emoji, and
+//              packing codes to keys and back             (codes/s)
+//   timestamp  getCurrentTimestamp(), stamped log lines (calls/s, lines/s)
+//
+// Each case is calibrated to run ≥ 20 ms per repetition, warmed up
+// once, then repeated; the median, min, mean and relative stddev of
+// the per‑item time are reported as CSV (default) or JSON.
+// ---------------------------------------------------------------
+// Build:   g++ -std=c++17 -O2 -pthread benchmark.cpp -o benchmark
+// Run:     ./benchmark [--format csv|json] [--reps N] [--seeds N] [--filter TEXT]
+//   format = output format on stdout            (default csv)
+//   reps   = timed repetitions per case         (default 7)
+//   seeds  = seeds per rain/logging repetition  (default 20000)
+//   filter = only cases whose group/name contains TEXT
+// ---------------------------------------------------------------
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "prime_rain.hpp"
+#include "prime_rank_select.hpp"
+#include "log_sink.hpp"
+#include "timestamp.hpp"
+#include "code_engine.hpp"
+#include "code_pack.hpp"
+
+// ───────────────────────── measurement harness ─────────────────────────────
+template <class T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct BenchResult {
+    std::string group, name, param, unit;
+    double itemsPerRep = 0;
+    std::vector<double> nsPerItem;   // one entry per repetition
+};
+
+struct BenchOptions {
+    std::string format = "csv";
+    size_t reps  = 7;
+    size_t seeds = 20000;
+    std::string filter;
+};
+
+BenchOptions opts;
+std::vector<BenchResult> results;
+
+// Times fn(), which processes `items` items per call.
+template <class Fn>
+void measure(const std::string& group, const std::string& name, const std::string& param,
+             const std::string& unit, double items, Fn&& fn) {
+    if (!opts.filter.empty() && (group + "/" + name).find(opts.filter) == std::string::npos) return;
+    using clock = std::chrono::steady_clock;
+
+    auto t0 = clock::now();
+    fn();                                                     // warm‑up + calibration
+    const double once = std::chrono::duration<double>(clock::now() - t0).count();
+    const size_t inner = std::max<size_t>(1, static_cast<size_t>(std::ceil(0.02 / std::max(once, 1e-9))));
+
+    BenchResult r{group, name, param, unit, items * inner, {}};
+    for (size_t rep = 0; rep < opts.reps; ++rep) {
+        t0 = clock::now();
+        for (size_t i = 0; i < inner; ++i) fn();
+        const double sec = std::chrono::duration<double>(clock::now() - t0).count();
+        r.nsPerItem.push_back(sec * 1e9 / r.itemsPerRep);
+    }
+    std::cerr << "  " << group << "/" << name << " " << param << " done\n";
+    results.push_back(std::move(r));
+}
+
+void printResults() {
+    char buf[512];
+    const bool json = opts.format == "json";
+    if (json) std::cout << "{\"benchmarks\": [\n";
+    else      std::cout << "group,name,param,unit,reps,items_per_rep,median_ns,min_ns,mean_ns,stddev_pct,per_second\n";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        std::vector<double> v = r.nsPerItem;
+        std::sort(v.begin(), v.end());
+        const double median = v.size() % 2 ? v[v.size() / 2] : (v[v.size() / 2 - 1] + v[v.size() / 2]) / 2;
+        double mean = 0, var = 0;
+        for (double x : v) mean += x;
+        mean /= v.size();
+        for (double x : v) var += (x - mean) * (x - mean);
+        const double stddevPct = v.size() > 1 ? 100.0 * std::sqrt(var / (v.size() - 1)) / mean : 0.0;
+
+        if (json) {
+            std::snprintf(buf, sizeof(buf),
+                          "  {\"group\": \"%s\", \"name\": \"%s\", \"param\": \"%s\", \"unit\": \"%s\", "
+                          "\"reps\": %zu, \"items_per_rep\": %.0f, \"median_ns\": %.4f, \"min_ns\": %.4f, "
+                          "\"mean_ns\": %.4f, \"stddev_pct\": %.2f, \"per_second\": %.1f}%s\n",
+                          r.group.c_str(), r.name.c_str(), r.param.c_str(), r.unit.c_str(), v.size(),
+                          r.itemsPerRep, median, v.front(), mean, stddevPct, 1e9 / median,
+                          i + 1 < results.size() ? "," : "");
+        } else {
+            std::snprintf(buf, sizeof(buf), "%s,%s,%s,%s,%zu,%.0f,%.4f,%.4f,%.4f,%.2f,%.1f\n",
+                          r.group.c_str(), r.name.c_str(), r.param.c_str(), r.unit.c_str(), v.size(),
+                          r.itemsPerRep, median, v.front(), mean, stddevPct, 1e9 / median);
+        }
+        std::cout << buf;
+    }
+    if (json) std::cout << "]}\n";
+}
+
+// ─────────────────────────── inputs ─────────────────────────────────────────
+// The original v1/v2 primality test, kept as the baseline.
+bool trialDivision(uint32_t n) {
+    if (n < 2) return false;
+    if (n % 2 == 0) return n == 2;
+    if (n % 3 == 0) return n == 3;
+    uint32_t r = static_cast<uint32_t>(std::sqrt(n));
+    for (uint32_t f = 5; f <= r; f += 6) {
+        if (n % f == 0 || n % (f + 2) == 0) return false;
+    }
+    return true;
+}
+
+std::vector<uint64_t> randomOfWidth(int digits, size_t count, bool primesOnly) {
+    uint64_t lo = 1;
+    for (int d = 1; d < digits; ++d) lo *= 10;
+    std::mt19937_64 rng(digits * 7919);
+    std::uniform_int_distribution<uint64_t> dist(lo, lo * 10 - 1);
+    std::vector<uint64_t> v;
+    while (v.size() < count) {
+        uint64_t n = dist(rng);
+        if (primesOnly) while (!isPrime64(n)) n = (n + 1 <= lo * 10 - 1) ? n + 1 : lo;
+        v.push_back(n);
+    }
+    return v;
+}
+
+// ─────────────────────────── benchmark groups ───────────────────────────────
+void benchPrimality() {
+    constexpr size_t N = 4096;
+    for (int digits : {4, 8, 12, 16, 19}) {
+        const std::string param = "digits=" + std::to_string(digits);
+        for (bool primesOnly : {false, true}) {
+            auto v = randomOfWidth(digits, N, primesOnly);
+            measure("primality", primesOnly ? "isPrime64/primes" : "isPrime64/random", param, "candidates", N, [&] {
+                size_t hits = 0;
+                for (uint64_t n : v) hits += isPrime64(n);
+                doNotOptimize(hits);
+            });
+        }
+    }
+
+    setRainDigits(8);
+    const bool haveBitmap = loadRainBitmap(std::max(1u, std::thread::hardware_concurrency()));
+    auto v = randomOfWidth(8, N, false);
+    std::vector<uint32_t> v32(v.begin(), v.end());
+    std::vector<uint8_t> out(N);
+
+    if (haveBitmap) {
+        measure("primality", "bitmap", "digits=8", "candidates", N, [&] {
+            size_t hits = 0;
+            for (uint32_t n : v32) hits += primeBitmap.test(n);
+            doNotOptimize(hits);
+        });
+    }
+    measure("primality", "trial_division", "digits=8", "candidates", N, [&] {
+        size_t hits = 0;
+        for (uint32_t n : v32) hits += trialDivision(n);
+        doNotOptimize(hits);
+    });
+    measure("primality", std::string("isPrimeBatch/") + primeBatchKernel(), "digits=8", "candidates", N, [&] {
+        isPrimeBatch(v32.data(), v32.size(), out.data());
+        doNotOptimize(out[0]);
+    });
+    measure("primality", std::string("prefilter/") + primeBatchKernel(), "digits=8", "candidates", N, [&] {
+        primeBatchPrefilter(v32.data(), v32.size(), out.data());
+        doNotOptimize(out[0]);
+    });
+}
+
+// Hops in one run of `seeds` seeds under the fixed benchmark master seed.
+double hopsPerRun(size_t seeds, size_t threads) {
+    std::vector<uint64_t> primes;
+    return static_cast<double>(runRain(seeds, threads, 32, primes, nullptr).hops);
+}
+
+std::vector<size_t> threadCounts() {
+    const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for (size_t t = 1; t < hw; t *= 2) counts.push_back(t);
+    counts.push_back(hw);
+    return counts;
+}
+
+void benchRain() {
+    MASTER_SEED = 42;
+    rainLog = RainLog::None;
+    for (int digits : {8, 12}) {
+        setRainDigits(digits);
+        loadRainBitmap(std::max(1u, std::thread::hardware_concurrency()));
+        for (size_t threads : threadCounts()) {
+            const double hops = hopsPerRun(opts.seeds, threads);
+            std::vector<uint64_t> primes;
+            measure("rain", "rainWorker", "digits=" + std::to_string(digits) + ";threads=" + std::to_string(threads),
+                    "hops", hops, [&] { runRain(opts.seeds, threads, 32, primes, nullptr); });
+        }
+    }
+}
+
+void benchLogging() {
+    MASTER_SEED = 42;
+    setRainDigits(8);
+    loadRainBitmap(std::max(1u, std::thread::hardware_concurrency()));
+    const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    const double hops = hopsPerRun(opts.seeds, threads);
+
+    for (RainLog mode : {RainLog::None, RainLog::Text, RainLog::Journal}) {
+        const char* name = mode == RainLog::None ? "none" : mode == RainLog::Text ? "text" : "journal";
+        rainLog = mode;
+        std::vector<uint64_t> primes;
+        uint64_t bytes = 0;
+        size_t runs = 0;
+        measure("logging", name, "threads=" + std::to_string(threads), "hops", hops, [&] {
+            int fd = ::open("/dev/null", O_WRONLY);
+            RingLogWriter writer(fd, threads, 1 << 20, OverflowPolicy::Block);
+            if (mode == RainLog::Journal) writer.setFramer(journalBlockHeader);
+            writer.start();
+            runRain(opts.seeds, threads, 32, primes, mode == RainLog::None ? nullptr : &writer);
+            writer.stop();
+            ::close(fd);
+            bytes += writer.bytesWritten();
+            ++runs;
+        });
+        if (runs) std::cerr << "    " << name << ": " << bytes / runs / hops << " log bytes per hop\n";
+    }
+    rainLog = RainLog::None;
+}
+
+void benchSampling() {
+    setRainDigits(8);
+    if (!loadRainBitmap(std::max(1u, std::thread::hardware_concurrency()))) return;
+    PrimeRankSelect index;
+    index.build(primeBitmap);
+
+    constexpr size_t N = 4096;
+    std::mt19937_64 gen(42);
+    std::vector<uint64_t> ranks(N), starts(N);
+    for (auto& k : ranks) k = gen() % index.count();
+    for (auto& n : starts) n = LOWER + gen() % (UPPER - LOWER + 1);
+
+    measure("sampling", "select", "digits=8", "primes", N, [&] {
+        uint64_t sum = 0;
+        for (uint64_t k : ranks) sum += index.prime(k);
+        doNotOptimize(sum);
+    });
+    measure("sampling", "nextPrime", "digits=8", "primes", N, [&] {
+        uint64_t sum = 0;
+        for (uint64_t n : starts) sum += index.nextPrime(n);
+        doNotOptimize(sum);
+    });
+    measure("sampling", "prevPrime", "digits=8", "primes", N, [&] {
+        uint64_t sum = 0;
+        for (uint64_t n : starts) sum += index.prevPrime(n);
+        doNotOptimize(sum);
+    });
+}
+
+const char* const CODE_STYLES[] = {"random", "checksum", "paired", "mirrored", "alternating"};
+
+template <class Alphabet>
+void benchAlphabet(const std::string& generator) {
+    constexpr size_t N = 10000;
+    for (int style = 1; style <= 5; ++style) {
+        withCodeStyle<Alphabet>(style, [&](auto engine) {
+            using Engine = decltype(engine);
+            measure("codes", generator + "/" + CODE_STYLES[style - 1], "len=8", "codes", N, [&] {
+                CodeRng rng(42);
+                char code[Engine::BUFFER_BYTES];
+                size_t bytes = 0;
+                for (size_t i = 0; i < N; ++i) {
+                    bytes += Engine::generate(code, rng);
+                    doNotOptimize(code);
+                }
+                doNotOptimize(bytes);
+            });
+            std::vector<char> buf(Engine::fillBytes(N));
+            measure("codes", generator + "/" + CODE_STYLES[style - 1] + "/bulk", "len=8", "codes", N, [&] {
+                CodeRng rng(42);
+                doNotOptimize(Engine::fill(buf.data(), N, rng));
+                doNotOptimize(buf[0]);
+            });
+        });
+    }
+    // packed codes (code_pack.hpp): text lines → keys → text lines
+    withCodeStyle<Alphabet>(1, [&](auto engine) {
+        using Engine = decltype(engine);
+        std::vector<char> text(Engine::fillBytes(N));
+        std::vector<uint64_t> keys(N);
+        CodeRng rng(42);
+        const size_t len = Engine::fill(text.data(), N, rng);
+        measure("codes", generator + "/pack", "len=8", "codes", N, [&] {
+            uint64_t skipped = 0;
+            doNotOptimize(packLines<Alphabet>(text.data(), text.data() + len, keys.data(), skipped));
+            doNotOptimize(keys[0]);
+        });
+        std::vector<char> back(unpackedBytes<Alphabet>(N));
+        measure("codes", generator + "/unpack", "len=8", "codes", N, [&] {
+            doNotOptimize(unpackLines<Alphabet>(keys.data(), N, back.data()));
+            doNotOptimize(back[0]);
+        });
+    });
+}
+
+void benchCodes() {
+    benchAlphabet<LetterAlphabet>("string");
+    benchAlphabet<DigitAlphabet>("integer");
+    benchAlphabet<EmojiAlphabet>("emoji");
+}
+
+void benchTimestamp() {
+    constexpr size_t N = 10000;
+    measure("timestamp", "getCurrentTimestamp", "", "calls", N, [&] {
+        size_t bytes = 0;
+        for (size_t i = 0; i < N; ++i) bytes += getCurrentTimestamp().size();
+        doNotOptimize(bytes);
+    });
+    // LogSink::stampedLine into /dev/null: cached stamp + memcpy, one write per MiB
+    const int fd = ::open("/dev/null", O_WRONLY);
+    if (fd < 0) return;
+    {
+        LogSink sink(fd);
+        measure("timestamp", "stampedLine", "len=8", "lines", N, [&] {
+            for (size_t i = 0; i < N; ++i) sink.stampedLine("QWERTYUI");
+        });
+    }
+    ::close(fd);
+}
+
+// ──────────────────────────── main ──────────────────────────────────────────
+int main(int argc, char* argv[]) {
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        if (arg == "--format" && a + 1 < argc)      opts.format = argv[++a];
+        else if (arg == "--reps" && a + 1 < argc)   opts.reps = std::max<size_t>(1, std::stoul(argv[++a]));
+        else if (arg == "--seeds" && a + 1 < argc)  opts.seeds = std::max<size_t>(1, std::stoul(argv[++a]));
+        else if (arg == "--filter" && a + 1 < argc) opts.filter = argv[++a];
+        else {
+            std::cerr << "Usage: ./benchmark [--format csv|json] [--reps N] [--seeds N] [--filter TEXT]\n";
+            return 1;
+        }
+    }
+    if (opts.format != "csv" && opts.format != "json") {
+        std::cerr << "Format must be csv or json.\n";
+        return 1;
+    }
+
+    benchPrimality();
+    benchRain();
+    benchLogging();
+    benchSampling();
+    benchCodes();
+    benchTimestamp();
+
+    printResults();
+    return 0;
+}
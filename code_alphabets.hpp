@@ -0,0 +1,159 @@
+// code_alphabets.hpp
+// The three symbol sets behind string, integer and emoji codes.
+// Each alphabet is a compile-time table plus the per-alphabet details
+// the styles need: checksum bias, pair offset and the two subsets the
+// alternating style switches between. parse() is put() in reverse, for
+// tools that read issued codes back from the logs.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// --- Letters A-Z ---
+struct LetterAlphabet {
+    static constexpr char FIRST = 'A';   // one byte per symbol: FIRST .. FIRST + SIZE - 1
+    static constexpr size_t SIZE = 26;
+    static constexpr size_t MAX_SYMBOL_BYTES = 1;
+    static constexpr size_t PUT_SLACK = 0;
+    static constexpr unsigned CHECKSUM_BIAS = 'A';   // the checksum sums character codes
+    static constexpr unsigned PAIR_OFFSET = 5;
+    static constexpr std::array<uint8_t, 21> ALT_EVEN = {1, 2, 3, 5, 6, 7, 9, 10, 11, 12, 13,
+                                                         15, 16, 17, 18, 19, 21, 22, 23, 24, 25};   // consonants
+    static constexpr std::array<uint8_t, 5> ALT_ODD = {0, 4, 8, 14, 20};                          // vowels
+
+    static constexpr size_t symbolBytes(unsigned) { return 1; }
+    static size_t put(char* out, unsigned index) {
+        *out = static_cast<char>('A' + index);
+        return 1;
+    }
+    // Index of the symbol at p (its byte length in `bytes`), or -1.
+    static int parse(const char* p, const char* end, size_t& bytes) {
+        bytes = 1;
+        return p < end && *p >= 'A' && *p <= 'Z' ? *p - 'A' : -1;
+    }
+};
+
+// --- Digits 0-9 ---
+struct DigitAlphabet {
+    static constexpr char FIRST = '0';
+    static constexpr size_t SIZE = 10;
+    static constexpr size_t MAX_SYMBOL_BYTES = 1;
+    static constexpr size_t PUT_SLACK = 0;
+    static constexpr unsigned CHECKSUM_BIAS = 0;
+    static constexpr unsigned PAIR_OFFSET = 3;
+    static constexpr std::array<uint8_t, 5> ALT_EVEN = {0, 2, 4, 6, 8};
+    static constexpr std::array<uint8_t, 5> ALT_ODD = {1, 3, 5, 7, 9};
+
+    static constexpr size_t symbolBytes(unsigned) { return 1; }
+    static size_t put(char* out, unsigned index) {
+        *out = static_cast<char>('0' + index);
+        return 1;
+    }
+    static int parse(const char* p, const char* end, size_t& bytes) {
+        bytes = 1;
+        return p < end && *p >= '0' && *p <= '9' ? *p - '0' : -1;
+    }
+};
+
+// --- Emoji ---
+inline constexpr std::array<std::string_view, 50> EMOJI_SET = {
+    "😀", "😂", "🥰", "😎", "🤔", "😴", "🥳", "🤯", "😡", "😭", "👍", "👎", "🙏", "💪", "👀", "🧠", "🔥",
+    "💯", "🚀", "🎉", "❤️", "💔", "⭐️", "✨", "☀️", "🌙", "🌍", "✈️", "🚗", "💻", "🐶", "🐱", "🐭", "🦊",
+    "🐻", "🐼", "🐨", "🦁", "🐸", "🐢", "🍕", "🍔", "🍓", "🥑", "☕️", "🍺", "📚", "🎸", "⚽️", "🏆"};
+
+// First code point of a UTF-8 string (well-formed, non-empty).
+constexpr uint32_t utf8LeadCodePoint(std::string_view s) {
+    const auto b = [&](size_t i) { return static_cast<uint32_t>(static_cast<uint8_t>(s[i])); };
+    if (b(0) < 0x80) return b(0);
+    if (b(0) < 0xE0) return (b(0) & 0x1F) << 6 | (b(1) & 0x3F);
+    if (b(0) < 0xF0) return (b(0) & 0x0F) << 12 | (b(1) & 0x3F) << 6 | (b(2) & 0x3F);
+    return (b(0) & 0x07) << 18 | (b(1) & 0x3F) << 12 | (b(2) & 0x3F) << 6 | (b(3) & 0x3F);
+}
+
+// Multiplicative hash of x into 2^bits slots.
+constexpr unsigned hashSlot(uint32_t x, uint32_t mult, unsigned bits) {
+    return static_cast<uint32_t>(x * mult) >> (32 - bits);
+}
+
+// EMOJI_SET packed at a fixed 8-byte stride (zero padded) with a length
+// table, so writing a symbol is one 8-byte copy: no pointer chase and no
+// variable-length memcpy. The copy may run up to STRIDE-1 bytes past the
+// symbol; the next symbol or the line's '\n' overwrites that, and callers
+// leave PUT_SLACK bytes after the last code.
+struct EmojiAlphabet {
+    static constexpr size_t SIZE = EMOJI_SET.size();
+    static constexpr size_t STRIDE = 8;
+    static constexpr size_t PUT_SLACK = STRIDE - 1;
+    static constexpr size_t MAX_SYMBOL_BYTES = [] {
+        size_t m = 0;
+        for (auto e : EMOJI_SET) m = e.size() > m ? e.size() : m;
+        return m;
+    }();
+    static_assert(MAX_SYMBOL_BYTES <= STRIDE, "emoji does not fit the table stride");
+
+    static constexpr std::array<char, SIZE * STRIDE> PACKED = [] {
+        std::array<char, SIZE * STRIDE> t{};
+        for (size_t i = 0; i < SIZE; ++i)
+            for (size_t b = 0; b < EMOJI_SET[i].size(); ++b) t[i * STRIDE + b] = EMOJI_SET[i][b];
+        return t;
+    }();
+    static constexpr std::array<uint8_t, SIZE> LENGTH = [] {
+        std::array<uint8_t, SIZE> t{};
+        for (size_t i = 0; i < SIZE; ++i) t[i] = static_cast<uint8_t>(EMOJI_SET[i].size());
+        return t;
+    }();
+
+    static constexpr unsigned CHECKSUM_BIAS = 0;
+    static constexpr unsigned PAIR_OFFSET = 5;
+    static constexpr std::array<uint8_t, 10> ALT_EVEN = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};            // faces
+    static constexpr std::array<uint8_t, 10> ALT_ODD = {40, 41, 42, 43, 44, 45, 46, 47, 48, 49};   // objects
+
+    static constexpr size_t symbolBytes(unsigned index) { return LENGTH[index]; }
+    static size_t put(char* out, unsigned index) {
+        std::memcpy(out, PACKED.data() + index * STRIDE, STRIDE);
+        return LENGTH[index];
+    }
+
+    // Symbols are told apart by their first code point. BY_LEAD is a
+    // perfect hash of those code points into 512 slots, so parse() is a
+    // multiply, a table load and one compare of the whole symbol (which
+    // may carry a variation selector), with no search branches to
+    // mispredict on random codes.
+    static constexpr unsigned LEAD_BITS = 9;
+    static constexpr uint8_t NO_SYMBOL = 0xFF;
+    static constexpr uint32_t LEAD_MULT = [] {
+        for (uint32_t mult = 0x9E3779B1u;; mult += 2) {   // first odd multiplier without collisions
+            bool used[1 << LEAD_BITS] = {};
+            bool clash = false;
+            for (size_t i = 0; i < SIZE && !clash; ++i) {
+                const unsigned slot = hashSlot(utf8LeadCodePoint(EMOJI_SET[i]), mult, LEAD_BITS);
+                clash = used[slot];
+                used[slot] = true;
+            }
+            if (!clash) return mult;
+        }
+    }();
+    static constexpr std::array<uint8_t, 1 << LEAD_BITS> BY_LEAD = [] {
+        std::array<uint8_t, 1 << LEAD_BITS> t{};
+        for (auto& slot : t) slot = NO_SYMBOL;
+        for (size_t i = 0; i < SIZE; ++i)
+            t[hashSlot(utf8LeadCodePoint(EMOJI_SET[i]), LEAD_MULT, LEAD_BITS)] = static_cast<uint8_t>(i);
+        return t;
+    }();
+
+    static int parse(const char* p, const char* end, size_t& bytes) {
+        const size_t avail = static_cast<size_t>(end - p);
+        const uint8_t lead = avail ? static_cast<uint8_t>(*p) : 0;
+        const size_t cpBytes = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : 0;   // every emoji starts ≥ U+0800
+        if (cpBytes == 0 || avail < cpBytes) return -1;
+        const uint32_t cp = utf8LeadCodePoint(std::string_view(p, cpBytes));
+        const unsigned index = BY_LEAD[hashSlot(cp, LEAD_MULT, LEAD_BITS)];
+        if (index == NO_SYMBOL) return -1;
+        bytes = LENGTH[index];
+        if (avail < bytes || std::memcmp(p, EMOJI_SET[index].data(), bytes) != 0) return -1;
+        return static_cast<int>(index);
+    }
+};
@@ -0,0 +1,247 @@
+// code_engine.hpp
+// One generator for every code the string, integer and emoji programs
+// issue. CodeEngine<Alphabet, Length, Style> is specialised at compile
+// time; a code is drawn as symbol indices into a fixed array and then
+// rendered straight into a caller buffer of BUFFER_BYTES, so
+// nothing is allocated per code.
+//
+// Each style declares the radices of its random draws (e.g. 7 × 26 for
+// a checksum string). All draws of a code come from a single 64-bit
+// CodeRng value x: x is reduced onto the product of the radices with
+// Lemire's multiply-shift (rejecting the biased sliver), and draw k is
+// the k-th mixed-radix digit of that value, read independently as
+// high64(low64(x · r0⋯rk-1) · rk). No modulo, no rejection loops.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "code_alphabets.hpp"
+#include "code_rng.hpp"
+
+// --- Styles ---
+// draws() / radix(k) describe the random draws; build() turns them into
+// the Length symbol indices of one code. maxBytes() is the longest code
+// the style can render, so a batch is sized in one allocation.
+
+// Longest symbol among the entries of an index table.
+template <class A, class Table>
+constexpr size_t maxSymbolBytes(const Table& table) {
+    size_t m = 0;
+    for (auto i : table) m = A::symbolBytes(i) > m ? A::symbolBytes(i) : m;
+    return m;
+}
+
+// 1. Random: every symbol uniform.
+struct RandomStyle {
+    template <class A, size_t L> static constexpr size_t draws() { return L; }
+    template <class A, size_t L> static constexpr size_t maxBytes() { return L * A::MAX_SYMBOL_BYTES; }
+    template <class A, size_t L> static constexpr uint64_t radix(size_t) { return A::SIZE; }
+    template <class A, size_t L>
+    static void build(const uint8_t* d, std::array<uint8_t, L>& idx) {
+        for (size_t i = 0; i < L; ++i) idx[i] = d[i];
+    }
+};
+
+// 2. Checksum: the last symbol is the sum of the others' values mod SIZE.
+struct ChecksumStyle {
+    template <class A, size_t L> static constexpr size_t draws() { return L - 1; }
+    template <class A, size_t L> static constexpr size_t maxBytes() { return L * A::MAX_SYMBOL_BYTES; }
+    template <class A, size_t L> static constexpr uint64_t radix(size_t) { return A::SIZE; }
+    template <class A, size_t L>
+    static void build(const uint8_t* d, std::array<uint8_t, L>& idx) {
+        unsigned sum = A::CHECKSUM_BIAS * (L - 1);
+        for (size_t i = 0; i + 1 < L; ++i) {
+            idx[i] = d[i];
+            sum += d[i];
+        }
+        idx[L - 1] = static_cast<uint8_t>(sum % A::SIZE);
+    }
+};
+
+// 3. Paired: each random symbol is followed by itself shifted by PAIR_OFFSET.
+struct PairedStyle {
+    template <class A, size_t L> static constexpr size_t draws() { return L / 2; }
+    template <class A, size_t L> static constexpr size_t maxBytes() {
+        size_t pair = 0;
+        for (unsigned i = 0; i < A::SIZE; ++i) {
+            const size_t b = A::symbolBytes(i) + A::symbolBytes((i + A::PAIR_OFFSET) % A::SIZE);
+            pair = b > pair ? b : pair;
+        }
+        return L / 2 * pair;
+    }
+    template <class A, size_t L> static constexpr uint64_t radix(size_t) { return A::SIZE; }
+    template <class A, size_t L>
+    static void build(const uint8_t* d, std::array<uint8_t, L>& idx) {
+        static_assert(L % 2 == 0, "paired codes need an even length");
+        for (size_t i = 0; i < L / 2; ++i) {
+            idx[2 * i] = d[i];
+            idx[2 * i + 1] = static_cast<uint8_t>(d[i] + A::PAIR_OFFSET < A::SIZE ? d[i] + A::PAIR_OFFSET
+                                                                                   : d[i] + A::PAIR_OFFSET - A::SIZE);
+        }
+    }
+};
+
+// 4. Mirrored: the second half is the first half reversed and reflected (i -> SIZE-1-i).
+struct MirroredStyle {
+    template <class A, size_t L> static constexpr size_t draws() { return L / 2; }
+    template <class A, size_t L> static constexpr size_t maxBytes() {
+        size_t pair = 0;
+        for (unsigned i = 0; i < A::SIZE; ++i) {
+            const size_t b = A::symbolBytes(i) + A::symbolBytes(A::SIZE - 1 - i);
+            pair = b > pair ? b : pair;
+        }
+        return L / 2 * pair;
+    }
+    template <class A, size_t L> static constexpr uint64_t radix(size_t) { return A::SIZE; }
+    template <class A, size_t L>
+    static void build(const uint8_t* d, std::array<uint8_t, L>& idx) {
+        static_assert(L % 2 == 0, "mirrored codes need an even length");
+        for (size_t i = 0; i < L / 2; ++i) {
+            idx[i] = d[i];
+            idx[L - 1 - i] = static_cast<uint8_t>(A::SIZE - 1 - d[i]);
+        }
+    }
+};
+
+// 5. Alternating: even positions from ALT_EVEN, odd positions from ALT_ODD (table lookups).
+struct AlternatingStyle {
+    template <class A, size_t L> static constexpr size_t draws() { return L; }
+    template <class A, size_t L> static constexpr size_t maxBytes() {
+        return (L + 1) / 2 * maxSymbolBytes<A>(A::ALT_EVEN) + L / 2 * maxSymbolBytes<A>(A::ALT_ODD);
+    }
+    template <class A, size_t L> static constexpr uint64_t radix(size_t k) {
+        return k % 2 == 0 ? A::ALT_EVEN.size() : A::ALT_ODD.size();
+    }
+    template <class A, size_t L>
+    static void build(const uint8_t* d, std::array<uint8_t, L>& idx) {
+        for (size_t i = 0; i < L; ++i) idx[i] = (i % 2 == 0) ? A::ALT_EVEN[d[i]] : A::ALT_ODD[d[i]];
+    }
+};
+
+// --- Code keys ---
+// A code's identity independent of its style: its symbol indices read as a
+// base-SIZE number. Keys lie in [0, codeKeySpace()).
+template <class Alphabet, size_t Length>
+constexpr uint64_t codeKeySpace() {
+    uint64_t space = 1;
+    for (size_t i = 0; i < Length; ++i) space *= Alphabet::SIZE;
+    return space;
+}
+
+template <class Alphabet, size_t Length>
+uint64_t codeKey(const std::array<uint8_t, Length>& idx) {
+    uint64_t key = 0;
+    for (uint8_t i : idx) key = key * Alphabet::SIZE + i;
+    return key;
+}
+
+// Reads a rendered code back into its symbol indices; false unless
+// `text` is exactly Length symbols of the alphabet.
+template <class Alphabet, size_t Length>
+bool parseCode(std::string_view text, std::array<uint8_t, Length>& idx) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    for (size_t i = 0; i < Length; ++i) {
+        size_t bytes;
+        const int symbol = Alphabet::parse(p, end, bytes);
+        if (symbol < 0) return false;
+        idx[i] = static_cast<uint8_t>(symbol);
+        p += bytes;
+    }
+    return p == end;
+}
+
+// --- Engine ---
+template <class AlphabetT, size_t Length, class Style>
+struct CodeEngine {
+    using Alphabet = AlphabetT;
+    static constexpr size_t LENGTH = Length;
+    static constexpr size_t MAX_BYTES = Style::template maxBytes<Alphabet, Length>();
+    // A single-code buffer: symbol writes may overrun by up to PUT_SLACK bytes.
+    static constexpr size_t BUFFER_BYTES = MAX_BYTES + Alphabet::PUT_SLACK;
+    static constexpr size_t DRAWS = Style::template draws<Alphabet, Length>();
+
+    // PREFIX[k] = r0⋯rk-1 (mod 2^64); PREFIX[DRAWS] is the whole draw space.
+    static constexpr std::array<uint64_t, DRAWS + 1> PREFIX = [] {
+        std::array<uint64_t, DRAWS + 1> p{};
+        p[0] = 1;
+        for (size_t k = 0; k < DRAWS; ++k) p[k + 1] = p[k] * Style::template radix<Alphabet, Length>(k);
+        return p;
+    }();
+    static constexpr uint64_t SPACE = PREFIX[DRAWS];
+    static_assert(SPACE <= (uint64_t(1) << 52), "one 64-bit draw must cover a whole code");
+    static constexpr uint64_t THRESHOLD = (0 - SPACE) % SPACE;
+
+    template <class Rng>
+    static void draw(std::array<uint8_t, Length>& idx, Rng& rng) {
+        uint64_t x;
+        do {
+            x = rng.next();
+        } while (static_cast<uint64_t>(static_cast<unsigned __int128>(x) * SPACE) < THRESHOLD);
+
+        uint8_t d[DRAWS];
+        for (size_t k = 0; k < DRAWS; ++k) {
+            const uint64_t frac = x * PREFIX[k];
+            d[k] = static_cast<uint8_t>((static_cast<unsigned __int128>(frac) *
+                                         Style::template radix<Alphabet, Length>(k)) >> 64);
+        }
+        Style::template build<Alphabet, Length>(d, idx);
+    }
+
+    static size_t render(const std::array<uint8_t, Length>& idx, char* out) {
+        size_t bytes = 0;
+        for (uint8_t i : idx) bytes += Alphabet::put(out + bytes, i);
+        return bytes;
+    }
+
+    // Writes one code to out (room for BUFFER_BYTES) and returns its byte
+    // length; optionally stores the code's key.
+    template <class Rng>
+    static size_t generate(char* out, Rng& rng, uint64_t* key = nullptr) {
+        std::array<uint8_t, Length> idx;
+        draw(idx, rng);
+        if (key) *key = codeKey<Alphabet, Length>(idx);
+        return render(idx, out);
+    }
+
+    // Bulk path: `count` lines of prefix + code + '\n' into one contiguous
+    // buffer of fillBytes(count, prefix). Returns the bytes written.
+    static constexpr size_t lineBytes(std::string_view prefix = {}) { return prefix.size() + MAX_BYTES + 1; }
+    static constexpr size_t fillBytes(size_t count, std::string_view prefix = {}) {
+        return count * lineBytes(prefix) + Alphabet::PUT_SLACK;
+    }
+
+    // With `keys`, the key of line i is stored in keys[i].
+    template <class Rng>
+    static size_t fill(char* out, size_t count, Rng& rng, std::string_view prefix = {}, uint64_t* keys = nullptr) {
+        char* p = out;
+        for (size_t i = 0; i < count; ++i) {
+            std::memcpy(p, prefix.data(), prefix.size());
+            p += prefix.size();
+            p += generate(p, rng, keys ? keys + i : nullptr);
+            *p++ = '\n';
+        }
+        return static_cast<size_t>(p - out);
+    }
+};
+
+// Codes are 8 symbols throughout the programs.
+constexpr size_t CODE_LENGTH = 8;
+
+// Calls f(CodeEngine<...>{}) with the engine for 1-based style number `style`.
+// Returns false for an unknown style.
+template <class Alphabet, size_t Length = CODE_LENGTH, class F>
+bool withCodeStyle(int style, F&& f) {
+    switch (style) {
+        case 1: f(CodeEngine<Alphabet, Length, RandomStyle>{}); return true;
+        case 2: f(CodeEngine<Alphabet, Length, ChecksumStyle>{}); return true;
+        case 3: f(CodeEngine<Alphabet, Length, PairedStyle>{}); return true;
+        case 4: f(CodeEngine<Alphabet, Length, MirroredStyle>{}); return true;
+        case 5: f(CodeEngine<Alphabet, Length, AlternatingStyle>{}); return true;
+    }
+    return false;
+}
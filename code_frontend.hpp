@@ -0,0 +1,370 @@
+// code_frontend.hpp
+// The session shared by string.cpp, integer.cpp and emoji.cpp.
+// With no arguments: prompt for a style and a count, then log and print
+// the codes. With arguments: headless batch mode, e.g.
+//   ./string --style 2 --count 50000000 --out codes.log --timestamps session
+// which appends the codes through 1 MiB block writes (log_sink.hpp)
+// instead of two flushed lines per code. Batches are generated on --threads workers;
+// --seed S reproduces the exact same codes at any thread count;
+// --unique STATE never issues a code recorded in STATE (code_unique.hpp;
+// one run at a time per STATE);
+// --metrics FILE keeps per-thread counters and chunk fill latencies in
+// FILE while the batch runs (metrics.hpp); --format packed writes each
+// code as a 4-6 byte key instead of a text line (code_pack.hpp), and
+// --unpack FILE prints such a file back as a text log.
+#pragma once
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "code_engine.hpp"
+#include "code_pack.hpp"
+#include "code_parallel.hpp"
+#include "code_unique.hpp"
+#include "log_sink.hpp"
+#include "metrics.hpp"
+#include "timestamp.hpp"
+
+// What differs between the three programs.
+struct FrontendSpec {
+    const char* logPath;         // e.g. "string.log"
+    const char* promptSubject;   // "string generation"
+    const char* countNoun;       // "strings" (prompt)
+    const char* bannerNoun;      // "Strings" (banner)
+    const char* sessionNoun;     // "strings" (log header)
+    const char* metricsName;     // "string" (metric name prefix)
+    const char* styleNames[5];
+};
+
+// --- Headless batch mode ---
+// A full 64-bit master seed; random_device yields 32 bits per draw.
+inline uint64_t randomSeed() {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+}
+
+struct BatchOptions {
+    int style = 0;
+    unsigned long long count = 0;
+    std::string out;                // "" = the program's log, "-" = stdout
+    bool lineTimestamps = true;     // false: only the session header is stamped
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t seed = randomSeed();              // master seed; same seed, same codes at any --threads
+    std::string unique;             // state file of issued codes; "" = duplicates allowed
+    std::string metrics;            // periodic metrics dump; "" = none
+    double metricsEvery = 5;        // seconds between dumps
+    bool packed = false;            // fixed-width binary codes instead of text lines
+    std::string unpack;             // packed file to print as text; "" = generate
+};
+
+inline bool parseBatchOptions(int argc, char* argv[], BatchOptions& opts) {
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        if (a + 1 >= argc) return false;
+        const std::string value = argv[++a];
+        if (arg == "--style") {
+            opts.style = std::atoi(value.c_str());
+        } else if (arg == "--count") {
+            opts.count = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--out") {
+            opts.out = value;
+        } else if (arg == "--threads") {
+            opts.threads = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--unique") {
+            opts.unique = value;
+        } else if (arg == "--metrics") {
+            opts.metrics = value;
+        } else if (arg == "--metrics-every") {
+            opts.metricsEvery = std::atof(value.c_str());
+        } else if (arg == "--seed") {
+            opts.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--timestamps") {
+            if (value != "line" && value != "session") return false;
+            opts.lineTimestamps = value == "line";
+        } else if (arg == "--format") {
+            if (value != "text" && value != "packed") return false;
+            opts.packed = value == "packed";
+        } else if (arg == "--unpack") {
+            opts.unpack = value;
+        } else {
+            return false;
+        }
+    }
+    if (!opts.unpack.empty()) return true;
+    return opts.style >= 1 && opts.style <= 5 && opts.count > 0;
+}
+
+// Reads until `len` bytes, end of input or an error; returns the bytes read.
+inline size_t readFull(int fd, char* p, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        const ssize_t n = ::read(fd, p + got, len - got);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        got += static_cast<size_t>(n);
+    }
+    return got;
+}
+
+template <class Alphabet>
+int runBatch(const FrontendSpec& spec, const BatchOptions& opts) {
+    using Set = UniqueCodeSet<Alphabet, CODE_LENGTH>;
+    if (opts.packed && opts.out.empty()) {
+        std::cerr << "Packed output needs --out FILE (or - for stdout); " << spec.logPath << " is a text log.\n";
+        return 1;
+    }
+    const bool uniqueMode = !opts.unique.empty();
+    Set issued;
+    if (uniqueMode) {
+        uint64_t space = 0;
+        withCodeStyle<Alphabet>(opts.style, [&](auto engine) { space = decltype(engine)::SPACE; });
+        if (opts.count > space) {
+            std::cerr << "Style " << opts.style << " has only " << space << " distinct codes.\n";
+            return 1;
+        }
+        if (!issued.open(opts.unique, codeKeySpace<Alphabet, CODE_LENGTH>(), Alphabet::SIZE, CODE_LENGTH)) {
+            if (issued.busy()) {
+                std::cerr << "Unique-code state " << opts.unique << " is in use by another run\n";
+                return 1;
+            }
+            std::cerr << "Cannot open unique-code state " << opts.unique << " (missing, corrupt or another alphabet)\n";
+            return 1;
+        }
+    }
+    const uint64_t issuedBefore = issued.size();
+
+    const std::string path = opts.out.empty() ? spec.logPath : opts.out;
+    const int fd = (path == "-") ? STDOUT_FILENO : LogSink::openAppend(path);
+    if (fd < 0) {
+        std::cerr << "Cannot open " << path << "\n";
+        return 1;
+    }
+
+    // workers 0..threads-1 fill chunks; the "writer" shard is this thread's log writes
+    Metrics metrics(spec.metricsName, "chunk_fill_ns", opts.threads, true);
+    std::unique_ptr<MetricsDumper> dumper;
+    if (!opts.metrics.empty()) {
+        dumper.reset(new MetricsDumper(metrics, opts.metrics, opts.metricsEvery));
+        dumper->start();
+    }
+
+    bool failed, exhausted = false, stateFailed = false;
+    {
+        LogSink out(fd);
+        if (opts.packed) {
+            const PackedFileHeader h = packedHeader<Alphabet>(opts.style, opts.seed, opts.count);
+            out.append(reinterpret_cast<const char*>(&h), sizeof(h));
+        } else {
+            out.append("\n" + getCurrentTimestamp() + " --- Session Start: Generating " + std::to_string(opts.count) +
+                       " " + spec.sessionNoun + " with style " + std::to_string(opts.style) + " ---\n");
+        }
+
+        withCodeStyle<Alphabet>(opts.style, [&](auto engine) {
+            using Engine = decltype(engine);
+            UniqueChunkFilter<Engine, Set> filter(issued, opts.seed);
+            const bool done = generateOrdered<Engine>(
+                opts.count, opts.threads, opts.seed, opts.lineTimestamps && !opts.packed, uniqueMode || opts.packed,
+                [&](const OrderedChunk& chunk) {
+                    const char* bytes = chunk.bytes;
+                    size_t len = chunk.len;
+                    if (uniqueMode && !filter.filter(chunk, bytes, len)) return false;
+                    if (uniqueMode && !issued.commit()) {   // keys on disk before their codes go out
+                        stateFailed = true;
+                        return false;
+                    }
+                    if (opts.packed) {
+                        const uint64_t* keys = uniqueMode ? filter.keys() : chunk.keys;
+                        const size_t packedLen = chunk.count * PackedCode<Alphabet>::BYTES;
+                        out.commit(storeKeys<Alphabet>(keys, chunk.count, out.reserve(packedLen)));
+                    } else {
+                        out.append(bytes, len);
+                    }
+                    metrics.writer().logBytes.store(out.bytesWritten(), std::memory_order_relaxed);
+                    metrics.writer().waitNs.store(out.writeNanos(), std::memory_order_relaxed);
+                    return true;
+                }, &metrics);
+            exhausted = !done && !stateFailed;
+        });
+        out.flush();
+        failed = out.failed();
+        metrics.writer().logBytes.store(out.bytesWritten(), std::memory_order_relaxed);
+        metrics.writer().waitNs.store(out.writeNanos(), std::memory_order_relaxed);
+    }
+    if (dumper && !dumper->stop()) {
+        std::cerr << "Cannot write metrics to " << opts.metrics << "\n";
+    }
+    if (fd != STDOUT_FILENO) ::close(fd);
+    if (uniqueMode && (!issued.close() || stateFailed)) {
+        std::cerr << "Cannot save unique-code state " << opts.unique << "; the batch was cut short.\n";
+        return 1;
+    }
+
+    if (exhausted) {
+        std::cerr << "Unique codes for style " << opts.style << " ran out; the batch was cut short.\n";
+        return 1;
+    }
+    if (failed) {
+        std::cerr << "Write to " << path << " failed.\n";
+        return 1;
+    }
+    std::cerr << "--- Logged " << opts.count << " " << (opts.packed ? "packed " : "") << spec.sessionNoun << " to "
+              << path << " (master seed " << opts.seed << ", " << opts.threads << " threads) ---\n";
+    if (uniqueMode) {
+        std::cerr << "--- " << opts.unique << " held " << issuedBefore << " issued codes; none were repeated ---\n";
+    }
+    return 0;
+}
+
+// --- Unpacking ---
+// Prints a --format packed file as the text log the batch would have
+// written with --timestamps session: each section's header line stamped
+// with its start time, then one code per line.
+template <class Alphabet>
+int runUnpack(const FrontendSpec& spec, const BatchOptions& opts) {
+    using Packed = PackedCode<Alphabet>;
+    constexpr size_t BLOCK = 4096;   // codes per read; unpacked they stay well inside the sink's buffer
+    const int in = opts.unpack == "-" ? STDIN_FILENO : ::open(opts.unpack.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        std::cerr << "Cannot open " << opts.unpack << "\n";
+        return 1;
+    }
+    const std::string path = opts.out.empty() ? "-" : opts.out;
+    const int fd = path == "-" ? STDOUT_FILENO : LogSink::openAppend(path);
+    if (fd < 0) {
+        std::cerr << "Cannot open " << path << "\n";
+        if (in != STDIN_FILENO) ::close(in);
+        return 1;
+    }
+
+    bool corrupt = false, failed;
+    uint64_t codes = 0, sections = 0;
+    {
+        LogSink out(fd);
+        std::vector<char> packed(BLOCK * Packed::BYTES);
+        std::vector<uint64_t> keys(BLOCK);
+        PackedFileHeader h;
+        size_t got;
+        while (!corrupt && (got = readFull(in, reinterpret_cast<char*>(&h), sizeof(h))) != 0) {
+            if (got != sizeof(h) || !packedHeaderMatches<Alphabet>(h)) {
+                corrupt = true;
+                break;
+            }
+            ++sections;
+            char stamp[32];
+            const size_t stampLen = formatTimestamp(static_cast<std::time_t>(h.startTime), stamp, sizeof(stamp));
+            out.append("\n" + std::string(stamp, stampLen) + " --- Session Start: Generating " +
+                       std::to_string(h.count) + " " + spec.sessionNoun + " with style " + std::to_string(h.style) +
+                       " ---\n");
+            for (uint64_t left = h.count; left > 0;) {
+                const size_t n = static_cast<size_t>(std::min<uint64_t>(BLOCK, left));
+                got = readFull(in, packed.data(), n * Packed::BYTES);
+                const size_t whole = got / Packed::BYTES;
+                loadKeys<Alphabet>(packed.data(), whole, keys.data());
+                out.commit(unpackLines<Alphabet>(keys.data(), whole, out.reserve(unpackedBytes<Alphabet>(whole))));
+                codes += whole;
+                if (whole != n) {   // cut short, e.g. a batch that stopped early
+                    corrupt = true;
+                    break;
+                }
+                left -= n;
+            }
+        }
+        out.flush();
+        failed = out.failed();
+    }
+    if (in != STDIN_FILENO) ::close(in);
+    if (fd != STDOUT_FILENO) ::close(fd);
+
+    if (failed) {
+        std::cerr << "Write to " << path << " failed.\n";
+        return 1;
+    }
+    std::cerr << "--- Unpacked " << codes << " " << spec.sessionNoun << " in " << sections << " sections from "
+              << opts.unpack << " ---\n";
+    if (corrupt) {
+        std::cerr << opts.unpack << " is not a packed " << spec.metricsName << " file or ends early.\n";
+        return 1;
+    }
+    return 0;
+}
+
+// --- Interactive session ---
+template <class Alphabet>
+int runFrontend(const FrontendSpec& spec, int argc, char* argv[]) {
+    if (argc > 1) {
+        BatchOptions opts;
+        if (!parseBatchOptions(argc, argv, opts)) {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--style 1-5 --count N [--out FILE|-] [--timestamps line|session]"
+                         " [--threads T] [--seed S] [--unique STATE] [--metrics FILE [--metrics-every SEC]]"
+                         " [--format text|packed]]\n"
+                      << "       " << argv[0] << " --unpack FILE|- [--out FILE|-]\n"
+                      << "  --unique STATE  never repeat a code recorded in STATE; one run at a time may use it\n";
+            return 1;
+        }
+        return opts.unpack.empty() ? runBatch<Alphabet>(spec, opts) : runUnpack<Alphabet>(spec, opts);
+    }
+
+    int choice, n;
+    std::cout << "Select an algorithm style for " << spec.promptSubject << ":\n";
+    for (int s = 0; s < 5; ++s) std::cout << s + 1 << ". " << spec.styleNames[s] << "\n";
+    std::cout << "Enter your choice (1-5): ";
+    std::cin >> choice;
+
+    std::cout << "How many " << spec.countNoun << " would you like to generate? ";
+    std::cin >> n;
+
+    if (choice < 1 || choice > 5 || n <= 0) {
+        std::cout << "Invalid input.\n";
+        return 1;
+    }
+
+    const int fd = LogSink::openAppend(spec.logPath);
+    if (fd < 0) {
+        std::cout << "Cannot open " << spec.logPath << "\n";
+        return 1;
+    }
+    std::cout << "\n--- Generating and logging " << n << " " << spec.bannerNoun << " to " << spec.logPath << " ---"
+              << std::endl;   // the codes below bypass std::cout
+
+    bool failed;
+    {
+        // codes reach the screen in 64 KiB blocks, or after 100 ms at the latest
+        LogSink logFile(fd);
+        LogSink screen(STDOUT_FILENO, 64 << 10, std::chrono::milliseconds(100));
+        logFile.append("\n" + getCurrentTimestamp() + " --- Session Start: Generating " + std::to_string(n) + " " +
+                       spec.sessionNoun + " with style " + std::to_string(choice) + " ---\n");
+
+        CodeRng rng(std::random_device{}());
+        withCodeStyle<Alphabet>(choice, [&](auto engine) {
+            using Engine = decltype(engine);
+            char code[Engine::BUFFER_BYTES];
+            for (int i = 0; i < n; ++i) {
+                const std::string_view text(code, Engine::generate(code, rng));
+                logFile.stampedLine(text);
+                screen.line(text);
+            }
+        });
+        logFile.flush();
+        failed = logFile.failed();
+    }
+    ::close(fd);
+    if (failed) {
+        std::cout << "Write to " << spec.logPath << " failed.\n";
+        return 1;
+    }
+    std::cout << "--- Logging complete. ---\n";
+    return 0;
+}
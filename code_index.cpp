@@ -0,0 +1,681 @@
+// code_index.cpp
+// ---------------------------------------------------------------
+// "Was this code ever issued, and when?" for integer.log, string.log
+// and emoji.log (or any batch --out file) without grepping gigabytes.
+//
+// The first run reads the whole log into LOG.idx; later runs only
+// parse what was appended since the offset recorded in the index. The
+// index is one mmap-able file:
+//
+//   CodeIndexHeader
+//   IndexSession[sessions]     every "Session Start" header seen
+//   uint64_t dir[2^16 + 1]     first entry of each key bucket
+//   IndexEntry[entries]        (code key, session, time), sorted by key
+//
+// A code's key is its symbol indices read as a base-SIZE number
+// (packCode in code_pack.hpp; emoji are mapped back through
+// EMOJI_SET), so lookups never compare strings. Keys of random codes
+// are uniform, so the 65 536-bucket directory leaves a few entries to
+// binary-search: a single lookup is a couple of cache misses, and
+// --bulk spreads lookups over all cores.
+//
+// New lines are parsed on all cores (one range per thread, as in
+// code_validate), sorted, and merged with the existing entries into a
+// new index, which replaces the old one by rename. Very large logs are
+// ingested in 1 GiB passes so memory stays bounded.
+// ---------------------------------------------------------------
+// Build:   g++ -std=c++17 -O2 -pthread code_index.cpp -o code_index
+// Run:     ./code_index LOG [--index FILE] [--alphabet letters|digits|emoji] [--threads T]
+//          ./code_index LOG --query CODE [CODE ...]
+//          ./code_index LOG --bulk FILE|-
+//   index    = index file                      (default LOG.idx)
+//   alphabet = symbols of the codes            (default: from the index, else from
+//              the log's first code line; for a log without codes yet, emoji
+//              for *emoji*, digits for *integer*, letters otherwise)
+//   query    = look codes up; every issue is listed with its time and session
+//   bulk     = one code per line in, "code<TAB>times issued<TAB>first time<TAB>session" out
+// Without --query / --bulk the index is brought up to date with the log.
+// Queries read the index as it is; exit status 1 if a queried code was
+// never issued.
+// ---------------------------------------------------------------
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "code_alphabets.hpp"
+#include "code_engine.hpp"
+#include "code_pack.hpp"
+
+// ───────────────────────────── file layout ──────────────────────────────────
+constexpr char     INDEX_MAGIC[8] = {'C', 'O', 'D', 'E', 'I', 'D', 'X', '1'};
+constexpr uint32_t INDEX_VERSION  = 1;
+constexpr uint32_t DIR_BITS       = 16;
+constexpr uint64_t DIR_BUCKETS    = uint64_t(1) << DIR_BITS;
+constexpr size_t   PASS_BYTES     = size_t(1) << 30;   // log bytes ingested per rewrite
+
+struct CodeIndexHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t alphabetSize;
+    uint32_t codeLength;
+    uint32_t dirBits;
+    uint64_t indexedBytes;   // the log is indexed up to here (always just after a '\n')
+    uint64_t sessions;
+    uint64_t entries;
+    uint64_t skippedLines;   // lines that were neither a code nor a session header
+};
+
+struct IndexSession {
+    uint64_t offset;         // of the header line in the log
+    uint64_t count;          // codes the session asked for
+    uint32_t time;           // header timestamp, 0 if none
+    uint32_t style;
+};
+
+// Times are the log's local "[YYYY-mm-dd HH:MM:SS]" read as if UTC, so
+// they print back exactly as logged; 0 = unknown (raw code files).
+struct IndexEntry {
+    uint64_t key;
+    uint32_t session;        // 1-based; 0 = before any session header
+    uint32_t time;
+};
+
+inline bool entryLess(const IndexEntry& a, const IndexEntry& b) {
+    if (a.key != b.key) return a.key < b.key;
+    if (a.session != b.session) return a.session < b.session;
+    return a.time < b.time;
+}
+
+inline size_t indexBytes(uint64_t sessions, uint64_t entries) {
+    return sizeof(CodeIndexHeader) + sessions * sizeof(IndexSession) + (DIR_BUCKETS + 1) * sizeof(uint64_t) +
+           entries * sizeof(IndexEntry);
+}
+
+// ───────────────────────────── timestamps ───────────────────────────────────
+constexpr size_t STAMP_BYTES = 21;   // "[YYYY-mm-dd HH:MM:SS]"
+
+inline bool parseStamp(const char* p, size_t len, uint32_t& t) {
+    if (len < STAMP_BYTES || p[0] != '[' || p[20] != ']') return false;
+    auto num = [&](int at, int digits, int& v) {
+        v = 0;
+        for (int i = at; i < at + digits; ++i) {
+            if (p[i] < '0' || p[i] > '9') return false;
+            v = v * 10 + (p[i] - '0');
+        }
+        return true;
+    };
+    std::tm tm{};
+    if (!num(1, 4, tm.tm_year) || !num(6, 2, tm.tm_mon) || !num(9, 2, tm.tm_mday) || !num(12, 2, tm.tm_hour) ||
+        !num(15, 2, tm.tm_min) || !num(18, 2, tm.tm_sec)) {
+        return false;
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    const time_t secs = timegm(&tm);
+    if (secs <= 0 || secs > static_cast<time_t>(UINT32_MAX)) return false;
+    t = static_cast<uint32_t>(secs);
+    return true;
+}
+
+inline std::string formatStamp(uint32_t t) {
+    if (t == 0) return "[time unknown]";
+    const time_t secs = t;
+    std::tm tm;
+    gmtime_r(&secs, &tm);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "[%Y-%m-%d %H:%M:%S]", &tm);
+    return buf;
+}
+
+// ───────────────────────────── log parsing ──────────────────────────────────
+constexpr uint32_t INHERITED_TIME = UINT32_MAX;   // un-stamped code before the range's first header
+
+struct ChunkEntries {
+    std::vector<IndexEntry>   entries;    // session: 0 = inherited, else 1-based within the range
+    std::vector<IndexSession> sessions;
+    uint64_t                  skipped = 0;
+};
+
+// "--- Session Start: Generating N x with style K ---"
+inline bool parseHeader(const char* p, size_t len, IndexSession& s) {
+    static const char START[] = "--- Session Start: Generating ";
+    static const char STYLE[] = "with style ";
+    if (len < sizeof(START) - 1 || std::memcmp(p, START, sizeof(START) - 1) != 0) return false;
+    s.count = std::strtoull(p + sizeof(START) - 1, nullptr, 10);
+    const char* st = static_cast<const char*>(memmem(p, len, STYLE, sizeof(STYLE) - 1));
+    s.style = st ? static_cast<uint32_t>(std::atoi(st + sizeof(STYLE) - 1)) : 0;
+    return true;
+}
+
+template <class Alphabet>
+void scanChunk(const char* base, size_t begin, size_t end, ChunkEntries& r) {
+    const char* p = base + begin;
+    const char* stop = base + end;
+    uint64_t key;
+    while (p < stop) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', stop - p));
+        const char* lineEnd = nl ? nl : stop;
+        const char* line = p;
+        size_t len = static_cast<size_t>(lineEnd - p);
+        p = lineEnd + 1;
+        if (len && line[len - 1] == '\r') --len;
+        if (len == 0) continue;
+
+        uint32_t time = 0;
+        const bool stamped = parseStamp(line, len, time);
+        const char* text = stamped ? line + STAMP_BYTES + 1 : line;
+        const size_t textLen = stamped ? (len > STAMP_BYTES ? len - STAMP_BYTES - 1 : 0) : len;
+
+        IndexSession s{};
+        if (packCode<Alphabet>(std::string_view(text, textLen), key)) {
+            if (!stamped) time = r.sessions.empty() ? INHERITED_TIME : r.sessions.back().time;
+            r.entries.push_back({key, static_cast<uint32_t>(r.sessions.size()), time});
+        } else if (parseHeader(text, textLen, s)) {
+            s.offset = static_cast<uint64_t>(line - base);
+            s.time = time;
+            r.sessions.push_back(s);
+        } else {
+            ++r.skipped;
+        }
+    }
+    std::sort(r.entries.begin(), r.entries.end(), entryLess);
+}
+
+// ───────────────────────────── the index file ───────────────────────────────
+class CodeIndex {
+public:
+    ~CodeIndex() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st{};
+        if (fd < 0) return false;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CodeIndexHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void* map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) return false;
+        map_ = map;
+        size_ = static_cast<size_t>(st.st_size);
+        header_ = static_cast<const CodeIndexHeader*>(map);
+        if (std::memcmp(header_->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || header_->version != INDEX_VERSION ||
+            header_->dirBits != DIR_BITS || size_ != indexBytes(header_->sessions, header_->entries)) {
+            close();
+            return false;
+        }
+        sessions_ = reinterpret_cast<const IndexSession*>(header_ + 1);
+        dir_ = reinterpret_cast<const uint64_t*>(sessions_ + header_->sessions);
+        entries_ = reinterpret_cast<const IndexEntry*>(dir_ + DIR_BUCKETS + 1);
+        return true;
+    }
+
+    void close() {
+        if (map_) munmap(map_, size_);
+        map_ = nullptr;
+        header_ = nullptr;
+    }
+
+    bool loaded() const { return header_ != nullptr; }
+    const CodeIndexHeader& header() const { return *header_; }
+    const IndexSession* sessions() const { return sessions_; }
+    const IndexEntry* entries() const { return entries_; }
+
+    // All issues of `key`, oldest first.
+    std::pair<const IndexEntry*, const IndexEntry*> find(uint64_t key, uint64_t space) const {
+        const uint64_t b = bucketOf(key, space);
+        const IndexEntry* lo = entries_ + dir_[b];
+        const IndexEntry* hi = entries_ + dir_[b + 1];
+        lo = std::lower_bound(lo, hi, key, [](const IndexEntry& e, uint64_t k) { return e.key < k; });
+        hi = lo;
+        while (hi < entries_ + header_->entries && hi->key == key) ++hi;
+        return {lo, hi};
+    }
+
+    static uint64_t bucketOf(uint64_t key, uint64_t space) {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(key) << DIR_BITS) / space);
+    }
+
+private:
+    void*                  map_ = nullptr;
+    size_t                 size_ = 0;
+    const CodeIndexHeader* header_ = nullptr;
+    const IndexSession*    sessions_ = nullptr;
+    const uint64_t*        dir_ = nullptr;
+    const IndexEntry*      entries_ = nullptr;
+};
+
+// Writes old + fresh entries (both sorted) and all sessions to `path`
+// through a temporary file.
+bool writeIndex(const std::string& path, const CodeIndexHeader& head, const IndexSession* oldSessions,
+                const std::vector<IndexSession>& newSessions, const IndexEntry* oldEntries, uint64_t oldCount,
+                const std::vector<IndexEntry>& fresh, uint64_t space) {
+    CodeIndexHeader h = head;
+    h.sessions = head.sessions + newSessions.size();
+    h.entries = oldCount + fresh.size();
+    const size_t bytes = indexBytes(h.sessions, h.entries);
+
+    const std::string tmp = path + ".tmp" + std::to_string(getpid());
+    const int fd = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(fd);
+        std::remove(tmp.c_str());
+        return false;
+    }
+    void* map = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+
+    std::memcpy(map, &h, sizeof(h));
+    auto* sessions = reinterpret_cast<IndexSession*>(static_cast<CodeIndexHeader*>(map) + 1);
+    std::copy(oldSessions, oldSessions + head.sessions, sessions);
+    std::copy(newSessions.begin(), newSessions.end(), sessions + head.sessions);
+    auto* dir = reinterpret_cast<uint64_t*>(sessions + h.sessions);
+    auto* entries = reinterpret_cast<IndexEntry*>(dir + DIR_BUCKETS + 1);
+    std::merge(oldEntries, oldEntries + oldCount, fresh.begin(), fresh.end(), entries, entryLess);
+
+    uint64_t b = 0;
+    for (uint64_t i = 0; i < h.entries; ++i) {
+        const uint64_t eb = CodeIndex::bucketOf(entries[i].key, space);
+        while (b <= eb) dir[b++] = i;
+    }
+    while (b <= DIR_BUCKETS) dir[b++] = h.entries;
+
+    const bool ok = msync(map, bytes, MS_SYNC) == 0;
+    munmap(map, bytes);
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ───────────────────────────── ingest ───────────────────────────────────────
+// Brings `indexPath` up to date with the log; false on any I/O error.
+template <class Alphabet>
+bool updateIndex(const std::string& logPath, const std::string& indexPath, size_t threads) {
+    constexpr uint64_t space = codeKeySpace<Alphabet, CODE_LENGTH>();
+    const int fd = ::open(logPath.c_str(), O_RDONLY);
+    struct stat st{};
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        std::cerr << "Cannot open " << logPath << "\n";
+        if (fd >= 0) ::close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    const char* base = nullptr;
+    if (size) {
+        void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            ::close(fd);
+            std::cerr << "Cannot map " << logPath << "\n";
+            return false;
+        }
+        madvise(map, size, MADV_SEQUENTIAL);
+        base = static_cast<const char*>(map);
+    }
+    ::close(fd);
+
+    CodeIndex index;
+    uint64_t from = 0;
+    if (index.open(indexPath)) {
+        from = index.header().indexedBytes;
+        if (from > size) {
+            std::cerr << logPath << " is shorter than the indexed " << from << " bytes (rotated?); rebuilding\n";
+            index.close();
+            from = 0;
+        }
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    uint64_t added = 0, parsedBytes = 0;
+    bool ok = true;
+    while (ok) {
+        // the next pass: whole lines only
+        const uint64_t cap = std::min<uint64_t>(size, from + PASS_BYTES);
+        uint64_t to = from;
+        for (uint64_t e = cap; e > from; --e) {
+            if (base[e - 1] == '\n') {
+                to = e;
+                break;
+            }
+        }
+        if (to == from) break;
+
+        const size_t parts = std::max<size_t>(1, std::min<size_t>(threads, (to - from) / (1 << 16) + 1));
+        std::vector<uint64_t> cut{from};
+        for (size_t t = 1; t < parts; ++t) {
+            uint64_t at = std::max<uint64_t>(cut.back(), from + (to - from) * t / parts);
+            const void* nl = at < to ? std::memchr(base + at, '\n', to - at) : nullptr;
+            cut.push_back(nl ? static_cast<uint64_t>(static_cast<const char*>(nl) - base) + 1 : to);
+        }
+        cut.push_back(to);
+
+        std::vector<ChunkEntries> chunks(parts);
+        std::vector<std::thread> pool;
+        for (size_t t = 0; t < parts; ++t) {
+            pool.emplace_back(scanChunk<Alphabet>, base, cut[t], cut[t + 1], std::ref(chunks[t]));
+        }
+        for (auto& th : pool) th.join();
+
+        // stitch: number sessions globally and resolve codes that precede
+        // their range's first header with the session carried in
+        CodeIndexHeader head{};
+        const IndexSession* oldSessions = nullptr;
+        const IndexEntry* oldEntries = nullptr;
+        uint64_t oldCount = 0;
+        if (index.loaded()) {
+            head = index.header();
+            oldSessions = index.sessions();
+            oldEntries = index.entries();
+            oldCount = head.entries;
+        } else {
+            std::memcpy(head.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+            head.version = INDEX_VERSION;
+            head.alphabetSize = static_cast<uint32_t>(Alphabet::SIZE);
+            head.codeLength = static_cast<uint32_t>(CODE_LENGTH);
+            head.dirBits = DIR_BITS;
+        }
+        std::vector<IndexSession> newSessions;
+        uint32_t session = static_cast<uint32_t>(head.sessions);
+        uint32_t sessionTime = session ? oldSessions[session - 1].time : 0;
+        std::vector<IndexEntry> fresh;
+        for (ChunkEntries& c : chunks) {
+            const uint32_t firstLocal = session;
+            for (IndexEntry& e : c.entries) {
+                if (e.session == 0) {
+                    e.session = session;
+                    if (e.time == INHERITED_TIME) e.time = sessionTime;
+                } else {
+                    e.session += firstLocal;
+                }
+            }
+            if (!c.sessions.empty()) {
+                session += static_cast<uint32_t>(c.sessions.size());
+                sessionTime = c.sessions.back().time;
+            }
+            newSessions.insert(newSessions.end(), c.sessions.begin(), c.sessions.end());
+            head.skippedLines += c.skipped;
+            const size_t mid = fresh.size();
+            fresh.insert(fresh.end(), c.entries.begin(), c.entries.end());
+            std::vector<IndexEntry>().swap(c.entries);
+            std::inplace_merge(fresh.begin(), fresh.begin() + mid, fresh.end(), entryLess);
+        }
+        head.indexedBytes = to;
+
+        ok = writeIndex(indexPath, head, oldSessions, newSessions, oldEntries, oldCount, fresh, space) &&
+             index.open(indexPath);
+        if (!ok) std::cerr << "Cannot write index " << indexPath << "\n";
+        added += fresh.size();
+        parsedBytes += to - from;
+        from = to;
+    }
+    if (base) munmap(const_cast<char*>(base), size);
+    if (!ok) return false;
+
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (!index.loaded() && !index.open(indexPath)) {
+        std::cerr << logPath << ": nothing to index\n";
+        return true;
+    }
+    const CodeIndexHeader& h = index.header();
+    std::cerr << indexPath << ": +" << added << " codes from " << parsedBytes << " new log bytes ("
+              << (sec > 0 ? parsedBytes / sec / 1e6 : 0) << " MB/s); " << h.entries << " codes in " << h.sessions
+              << " sessions, " << h.skippedLines << " other lines\n";
+    if (h.entries == 0 && h.skippedLines > 0) {   // nothing but unreadable lines: almost surely the wrong alphabet
+        index.close();
+        ::unlink(indexPath.c_str());
+        std::cerr << "No " << Alphabet::SIZE << "-symbol codes in " << logPath
+                  << "; pass the right --alphabet (index removed)\n";
+        return false;
+    }
+    return true;
+}
+
+// ───────────────────────────── queries ──────────────────────────────────────
+inline std::string describeSession(const CodeIndex& index, uint32_t session) {
+    if (session == 0) return "before any session";
+    const IndexSession& s = index.sessions()[session - 1];
+    return "session #" + std::to_string(session) + " (style " + std::to_string(s.style) + ", " +
+           std::to_string(s.count) + " codes, started " + formatStamp(s.time) + ", log offset " +
+           std::to_string(s.offset) + ")";
+}
+
+template <class Alphabet>
+bool querySingle(const CodeIndex& index, const std::vector<std::string>& codes) {
+    constexpr uint64_t space = codeKeySpace<Alphabet, CODE_LENGTH>();
+    bool allIssued = true;
+    for (const std::string& code : codes) {
+        uint64_t key;
+        if (!packCode<Alphabet>(code, key)) {
+            std::cout << code << ": not a valid code for this log\n";
+            allIssued = false;
+            continue;
+        }
+        const auto t0 = std::chrono::steady_clock::now();
+        const auto range = index.find(key, space);
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        const size_t n = static_cast<size_t>(range.second - range.first);
+        char took[32];
+        std::snprintf(took, sizeof(took), "  (%.2f us)\n", us);
+        if (n == 0) {
+            std::cout << code << ": never issued" << took;
+            allIssued = false;
+        } else {
+            std::cout << code << ": issued " << n << (n == 1 ? " time" : " times") << took;
+        }
+        for (const IndexEntry* e = range.first; e != range.second; ++e) {
+            std::cout << "  " << formatStamp(e->time) << " in " << describeSession(index, e->session) << "\n";
+        }
+    }
+    return allIssued;
+}
+
+template <class Alphabet>
+bool queryBulk(const CodeIndex& index, const std::string& path, size_t threads) {
+    constexpr uint64_t space = codeKeySpace<Alphabet, CODE_LENGTH>();
+    std::string input;
+    {
+        const int fd = path == "-" ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Cannot open " << path << "\n";
+            return false;
+        }
+        char buf[1 << 16];
+        for (ssize_t n; (n = ::read(fd, buf, sizeof(buf))) != 0;) {
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "Cannot read " << path << "\n";
+                return false;
+            }
+            input.append(buf, static_cast<size_t>(n));
+        }
+        if (fd != STDIN_FILENO) ::close(fd);
+    }
+    std::vector<std::string_view> lines;
+    for (size_t at = 0; at < input.size();) {
+        size_t nl = input.find('\n', at);
+        if (nl == std::string::npos) nl = input.size();
+        size_t len = nl - at;
+        if (len && input[at + len - 1] == '\r') --len;
+        if (len) lines.emplace_back(input.data() + at, len);
+        at = nl + 1;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const size_t parts = std::max<size_t>(1, std::min<size_t>(threads, lines.size() / 4096 + 1));
+    std::vector<std::string> out(parts);
+    std::vector<uint64_t> found(parts, 0);
+    auto work = [&](size_t t) {
+        std::string& o = out[t];
+        char buf[160];
+        for (size_t i = lines.size() * t / parts; i < lines.size() * (t + 1) / parts; ++i) {
+            const std::string_view code = lines[i];
+            o.append(code.data(), code.size());
+            uint64_t key;
+            if (!packCode<Alphabet>(code, key)) {
+                o += "\tinvalid\n";
+                continue;
+            }
+            const auto range = index.find(key, space);
+            if (range.first == range.second) {
+                o += "\t0\n";
+                continue;
+            }
+            ++found[t];
+            const int len = std::snprintf(buf, sizeof(buf), "\t%zu\t%s\t%u\n",
+                                          static_cast<size_t>(range.second - range.first),
+                                          formatStamp(range.first->time).c_str(), range.first->session);
+            o.append(buf, static_cast<size_t>(len));
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < parts; ++t) pool.emplace_back(work, t);
+    work(0);
+    for (auto& th : pool) th.join();
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    bool ok = true;
+    uint64_t issued = 0;
+    for (size_t t = 0; t < parts; ++t) {
+        ok = ok && std::fwrite(out[t].data(), 1, out[t].size(), stdout) == out[t].size();
+        issued += found[t];
+    }
+    ok = std::fflush(stdout) == 0 && ok;
+    std::cerr << lines.size() << " lookups, " << issued << " issued, "
+              << (sec > 0 ? lines.size() / sec / 1e6 : 0) << " M lookups/s on " << parts << " threads\n";
+    if (!ok) std::cerr << "Write to stdout failed\n";
+    return ok;
+}
+
+// ──────────────────────────────── main ──────────────────────────────────────
+template <class F>
+bool withAlphabet(const std::string& name, F&& f) {
+    if (name == "letters") f(LetterAlphabet{});
+    else if (name == "digits") f(DigitAlphabet{});
+    else if (name == "emoji") f(EmojiAlphabet{});
+    else return false;
+    return true;
+}
+
+inline std::string alphabetOfSize(uint32_t size) {
+    return size == LetterAlphabet::SIZE ? "letters" : size == DigitAlphabet::SIZE ? "digits"
+         : size == EmojiAlphabet::SIZE  ? "emoji"   : "";
+}
+
+// The alphabet of the first code line in the log's first MiB; "" if none.
+inline std::string detectAlphabet(const std::string& logPath) {
+    const int fd = ::open(logPath.c_str(), O_RDONLY);
+    if (fd < 0) return "";
+    std::vector<char> head(1 << 20);
+    ssize_t got;
+    while ((got = ::read(fd, head.data(), head.size())) < 0 && errno == EINTR) {}
+    ::close(fd);
+    const char* p = head.data();
+    const char* end = p + std::max<ssize_t>(got, 0);
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!nl) break;                                  // a line cut by the read is not trusted
+        size_t len = static_cast<size_t>(nl - p);
+        if (len && p[len - 1] == '\r') --len;
+        uint32_t time;
+        const bool stamped = parseStamp(p, len, time) && len > STAMP_BYTES;
+        const std::string_view text = stamped ? std::string_view(p + STAMP_BYTES + 1, len - STAMP_BYTES - 1)
+                                              : std::string_view(p, len);
+        uint64_t key;
+        if (packCode<LetterAlphabet>(text, key)) return "letters";
+        if (packCode<DigitAlphabet>(text, key)) return "digits";
+        if (packCode<EmojiAlphabet>(text, key)) return "emoji";
+        p = nl + 1;
+    }
+    return "";
+}
+
+int main(int argc, char* argv[]) {
+    const char* usage = "Usage: ./code_index LOG [--index FILE] [--alphabet letters|digits|emoji] [--threads T]\n"
+                        "                        [--query CODE ... | --bulk FILE|-]\n";
+    std::string logPath, indexPath, alphabet, bulk;
+    std::vector<std::string> queries;
+    bool query = false;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        if (arg == "--index" && a + 1 < argc)           indexPath = argv[++a];
+        else if (arg == "--alphabet" && a + 1 < argc)   alphabet = argv[++a];
+        else if (arg == "--threads" && a + 1 < argc)    threads = std::max(1, std::atoi(argv[++a]));
+        else if (arg == "--bulk" && a + 1 < argc)       bulk = argv[++a];
+        else if (arg == "--query")                      query = true;
+        else if (query && (arg[0] != '-' || arg == "-")) queries.push_back(arg);
+        else if (logPath.empty() && arg[0] != '-')      logPath = arg;
+        else {
+            std::cerr << usage;
+            return 1;
+        }
+    }
+    if (logPath.empty() || (query && queries.empty()) || (query && !bulk.empty())) {
+        std::cerr << usage;
+        return 1;
+    }
+    if (indexPath.empty()) indexPath = logPath + ".idx";
+
+    CodeIndex index;
+    const bool haveIndex = index.open(indexPath);
+    const std::string indexed = haveIndex ? alphabetOfSize(index.header().alphabetSize) : "";
+    if (alphabet.empty()) alphabet = !indexed.empty() ? indexed : detectAlphabet(logPath);
+    if (alphabet.empty()) {                                     // no code lines yet: go by the name
+        alphabet = logPath.find("emoji") != std::string::npos   ? "emoji"
+                 : logPath.find("integer") != std::string::npos ? "digits"
+                                                                : "letters";
+    }
+    if (!indexed.empty() && alphabet != indexed) {
+        std::cerr << indexPath << " indexes " << indexed << " codes, not " << alphabet << "\n";
+        return 1;
+    }
+
+    bool ok = true;
+    const bool known = withAlphabet(alphabet, [&](auto a) {
+        using Alphabet = decltype(a);
+        if (!query && bulk.empty()) {
+            index.close();
+            ok = updateIndex<Alphabet>(logPath, indexPath, threads);
+            return;
+        }
+        if (!haveIndex) {
+            std::cerr << "No index at " << indexPath << "; run ./code_index " << logPath << " first\n";
+            ok = false;
+            return;
+        }
+        struct stat st{};
+        if (::stat(logPath.c_str(), &st) == 0 && static_cast<uint64_t>(st.st_size) > index.header().indexedBytes) {
+            std::cerr << "(" << logPath << " has " << st.st_size - index.header().indexedBytes
+                      << " bytes not indexed yet)\n";
+        }
+        ok = query ? querySingle<Alphabet>(index, queries) : queryBulk<Alphabet>(index, bulk, threads);
+    });
+    if (!known) {
+        std::cerr << "Alphabet must be letters, digits or emoji\n";
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
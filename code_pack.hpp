@@ -0,0 +1,224 @@
+// code_pack.hpp
+// Codes as one 64-bit word. A PackedCode is the code's key (codeKey in
+// code_engine.hpp): its symbol indices read as a base-SIZE number, so 8
+// digits fit 27 bits, 8 letters 38 and 8 emoji 46. Comparing, sorting
+// and hashing packed codes are single-word operations, and key order is
+// symbol order — for letters and digits, the text's own sort order.
+//
+// packCode()/packLines() read text into keys and unpackCode()/
+// unpackLines() render keys as text. For the one-byte alphabets a whole
+// 8-symbol code is handled as one 64-bit word (SWAR): one load, a range
+// check on all eight bytes at once and three multiply-adds that merge
+// neighbouring symbols pairwise; rendering splits the key with constant
+// divisions in a tree of depth three and stores the eight bytes at once.
+//
+// Packed files (--format packed) are a sequence of sections, one per
+// batch: a PackedFileHeader and `count` codes of codeBytes little-endian
+// bytes each — 4 for digits, 5 for letters, 6 for emoji, against 9, 9
+// and up to 65 bytes per text line.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <string_view>
+
+#include "code_alphabets.hpp"
+#include "code_engine.hpp"
+
+// --- Packed codes ---
+constexpr unsigned bitsFor(uint64_t space) {
+    unsigned bits = 0;
+    while (bits < 64 && (space - 1) >> bits) ++bits;
+    return bits;
+}
+
+template <class AlphabetT, size_t Length = CODE_LENGTH>
+struct PackedCode {
+    using Alphabet = AlphabetT;
+    static constexpr size_t LENGTH = Length;
+    static constexpr uint64_t SPACE = codeKeySpace<Alphabet, Length>();
+    static constexpr unsigned BITS = bitsFor(SPACE);
+    static constexpr size_t BYTES = (BITS + 7) / 8;   // per code in a packed file
+    // Longest text form, and the room unpackCode() needs for it.
+    static constexpr size_t TEXT_BYTES = Length * Alphabet::MAX_SYMBOL_BYTES;
+    static constexpr size_t BUFFER_BYTES = TEXT_BYTES + Alphabet::PUT_SLACK;
+
+    uint64_t key = 0;
+
+    friend bool operator==(PackedCode a, PackedCode b) { return a.key == b.key; }
+    friend bool operator!=(PackedCode a, PackedCode b) { return a.key != b.key; }
+    friend bool operator<(PackedCode a, PackedCode b) { return a.key < b.key; }
+};
+
+namespace std {
+template <class Alphabet, size_t Length>
+struct hash<PackedCode<Alphabet, Length>> {
+    size_t operator()(PackedCode<Alphabet, Length> code) const noexcept { return hash<uint64_t>{}(code.key); }
+};
+}  // namespace std
+
+// One-byte alphabets with 8-symbol codes go a word at a time.
+template <class Alphabet, size_t Length>
+constexpr bool PACK_BY_WORD = Alphabet::MAX_SYMBOL_BYTES == 1 && Length == 8 &&
+                              __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+constexpr uint64_t BYTE_ONES = 0x0101010101010101ull;
+
+// The key of the 8 symbols in `word` (first symbol in the low byte);
+// false unless every byte is in FIRST .. FIRST + SIZE - 1.
+template <class Alphabet>
+bool packWord(uint64_t word, uint64_t& key) {
+    constexpr uint64_t N = Alphabet::SIZE;
+    constexpr uint64_t FIRST = static_cast<uint8_t>(Alphabet::FIRST);
+    // per byte (all below 0x80): bit 7 of word + (0x80 - FIRST) is set
+    // iff byte ≥ FIRST, and of word + (0x80 - FIRST - N) iff byte ≥ FIRST + N
+    const uint64_t geFirst = word + (0x80 - FIRST) * BYTE_ONES;
+    const uint64_t geEnd = word + (0x80 - FIRST - N) * BYTE_ONES;
+    if ((geFirst & ~geEnd & ~word & 0x80 * BYTE_ONES) != 0x80 * BYTE_ONES) return false;
+
+    const uint64_t d = word - FIRST * BYTE_ONES;                        // 8 × 8-bit symbols
+    const uint64_t pairs = (d & 0x00FF00FF00FF00FFull) * N +            // 4 × 16-bit d0·N + d1
+                           (d >> 8 & 0x00FF00FF00FF00FFull);
+    const uint64_t quads = (pairs & 0x0000FFFF0000FFFFull) * (N * N) +  // 2 × 32-bit
+                           (pairs >> 16 & 0x0000FFFF0000FFFFull);
+    key = (quads & 0xFFFFFFFFull) * (N * N * N * N) + (quads >> 32);
+    return true;
+}
+
+// packWord() in reverse.
+template <class Alphabet>
+uint64_t unpackWord(uint64_t key) {
+    constexpr uint64_t N = Alphabet::SIZE;
+    constexpr uint64_t FIRST = static_cast<uint8_t>(Alphabet::FIRST);
+    const auto pair = [](uint64_t p) { return p / N | (p % N) << 8; };
+    const auto quad = [&](uint64_t q) { return pair(q / (N * N)) | pair(q % (N * N)) << 16; };
+    constexpr uint64_t N4 = N * N * N * N;
+    return (quad(key / N4) | quad(key % N4) << 32) + FIRST * BYTE_ONES;
+}
+
+// The key of `text`; false unless it is exactly Length symbols of the alphabet.
+template <class Alphabet, size_t Length = CODE_LENGTH>
+bool packCode(std::string_view text, uint64_t& key) {
+    if constexpr (PACK_BY_WORD<Alphabet, Length>) {
+        if (text.size() != Length) return false;
+        uint64_t word;
+        std::memcpy(&word, text.data(), sizeof(word));
+        return packWord<Alphabet>(word, key);
+    } else {
+        std::array<uint8_t, Length> idx;
+        if (!parseCode<Alphabet, Length>(text, idx)) return false;
+        key = codeKey<Alphabet, Length>(idx);
+        return true;
+    }
+}
+
+// Writes the code with `key` to out (room for BUFFER_BYTES) and returns
+// its byte length.
+template <class Alphabet, size_t Length = CODE_LENGTH>
+size_t unpackCode(uint64_t key, char* out) {
+    if constexpr (PACK_BY_WORD<Alphabet, Length>) {
+        const uint64_t word = unpackWord<Alphabet>(key);
+        std::memcpy(out, &word, sizeof(word));
+        return Length;
+    } else {
+        std::array<uint8_t, Length> idx;
+        for (size_t i = Length; i-- > 0; key /= Alphabet::SIZE) idx[i] = static_cast<uint8_t>(key % Alphabet::SIZE);
+        size_t bytes = 0;
+        for (uint8_t i : idx) bytes += Alphabet::put(out + bytes, i);
+        return bytes;
+    }
+}
+
+// --- Bulk ---
+// Keys of the codes in the text lines [p, end), one code per line (a
+// trailing '\r' is ignored), into keys[], which needs a slot per line.
+// Returns the keys stored; other non-empty lines are counted in `skipped`.
+template <class Alphabet, size_t Length = CODE_LENGTH>
+size_t packLines(const char* p, const char* end, uint64_t* keys, uint64_t& skipped) {
+    size_t n = 0;
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        const char* lineEnd = nl ? nl : end;
+        size_t len = static_cast<size_t>(lineEnd - p);
+        if (len && p[len - 1] == '\r') --len;
+        if (packCode<Alphabet, Length>(std::string_view(p, len), keys[n])) ++n;
+        else if (len) ++skipped;
+        p = lineEnd + 1;
+    }
+    return n;
+}
+
+// Room unpackLines() needs for `count` codes.
+template <class Alphabet, size_t Length = CODE_LENGTH>
+constexpr size_t unpackedBytes(size_t count) {
+    return count * (PackedCode<Alphabet, Length>::TEXT_BYTES + 1) + Alphabet::PUT_SLACK;
+}
+
+// keys[0..count) as lines of code + '\n'; returns the bytes written.
+template <class Alphabet, size_t Length = CODE_LENGTH>
+size_t unpackLines(const uint64_t* keys, size_t count, char* out) {
+    char* p = out;
+    for (size_t i = 0; i < count; ++i) {
+        p += unpackCode<Alphabet, Length>(keys[i], p);
+        *p++ = '\n';
+    }
+    return static_cast<size_t>(p - out);
+}
+
+// keys[0..count) as BYTES-wide little-endian codes (count × BYTES bytes), and back.
+template <class Alphabet, size_t Length = CODE_LENGTH>
+size_t storeKeys(const uint64_t* keys, size_t count, char* out) {
+    constexpr size_t BYTES = PackedCode<Alphabet, Length>::BYTES;
+    for (size_t i = 0; i < count; ++i) std::memcpy(out + i * BYTES, &keys[i], BYTES);
+    return count * BYTES;
+}
+
+template <class Alphabet, size_t Length = CODE_LENGTH>
+void loadKeys(const char* in, size_t count, uint64_t* keys) {
+    constexpr size_t BYTES = PackedCode<Alphabet, Length>::BYTES;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key = 0;
+        std::memcpy(&key, in + i * BYTES, BYTES);
+        keys[i] = key;
+    }
+}
+
+// --- Packed files ---
+inline constexpr char PACKED_MAGIC[8] = {'C', 'O', 'D', 'E', 'P', 'A', 'K', '1'};
+
+struct PackedFileHeader {
+    char     magic[8];       // PACKED_MAGIC
+    uint32_t alphabetSize;   // 26, 10 or 50
+    uint32_t codeLength;     // symbols per code
+    uint32_t codeBytes;      // bytes per packed code
+    uint32_t style;          // 1..5
+    uint64_t masterSeed;
+    uint64_t count;          // codes that follow in this section
+    int64_t  startTime;      // unix time the batch started
+};
+static_assert(sizeof(PackedFileHeader) == 48, "packed file header layout");
+
+template <class Alphabet, size_t Length = CODE_LENGTH>
+PackedFileHeader packedHeader(int style, uint64_t masterSeed, uint64_t count) {
+    PackedFileHeader h{};
+    std::memcpy(h.magic, PACKED_MAGIC, sizeof(PACKED_MAGIC));
+    h.alphabetSize = static_cast<uint32_t>(Alphabet::SIZE);
+    h.codeLength = static_cast<uint32_t>(Length);
+    h.codeBytes = static_cast<uint32_t>(PackedCode<Alphabet, Length>::BYTES);
+    h.style = static_cast<uint32_t>(style);
+    h.masterSeed = masterSeed;
+    h.count = count;
+    h.startTime = static_cast<int64_t>(std::time(nullptr));
+    return h;
+}
+
+// True if `h` starts a section of codes over this alphabet and length.
+template <class Alphabet, size_t Length = CODE_LENGTH>
+bool packedHeaderMatches(const PackedFileHeader& h) {
+    return std::memcmp(h.magic, PACKED_MAGIC, sizeof(PACKED_MAGIC)) == 0 && h.alphabetSize == Alphabet::SIZE &&
+           h.codeLength == Length && h.codeBytes == PackedCode<Alphabet, Length>::BYTES;
+}
@@ -0,0 +1,126 @@
+// code_parallel.hpp
+// Multithreaded code generation with deterministic, ordered output.
+// A batch is cut into fixed chunks of CODE_CHUNK codes; chunk c is
+// always drawn from CodeRng(masterSeed, c), so the bytes for a given
+// master seed are identical at any thread count. Workers fill chunks
+// into a window of 2 × threads slot buffers and the calling thread
+// hands them to the sink strictly in chunk order.
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "code_engine.hpp"
+#include "code_rng.hpp"
+#include "metrics.hpp"
+#include "timestamp.hpp"
+
+constexpr uint64_t CODE_CHUNK = 16384;
+
+// One filled chunk as handed to the sink.
+struct OrderedChunk {
+    uint64_t        index;
+    const char*     bytes;         // `count` lines of prefix + code + '\n'
+    size_t          len;
+    size_t          count;
+    size_t          prefixBytes;   // timestamp prefix on every line (0 in session mode)
+    const uint64_t* keys;          // code keys, or null unless requested
+};
+
+// bool sink(const OrderedChunk&) receives the chunks in order; returning
+// false stops the batch, and generateOrdered then returns false. With
+// lineTimestamps every line is prefixed by the time its chunk was filled;
+// withKeys also records each code's key (code_unique.hpp). With
+// `metrics`, worker t counts its codes, chunk fill times and the time it
+// waited for a free slot in metrics->thread(t).
+template <class Engine, class Sink>
+bool generateOrdered(uint64_t count, size_t threads, uint64_t masterSeed, bool lineTimestamps, bool withKeys,
+                     Sink&& sink, Metrics* metrics = nullptr) {
+    threads = std::max<size_t>(1, threads);
+    const uint64_t chunks = (count + CODE_CHUNK - 1) / CODE_CHUNK;
+    const size_t window = 2 * threads;
+
+    struct Slot {
+        std::vector<char> bytes;
+        std::vector<uint64_t> keys;
+        size_t used = 0;
+        size_t count = 0;
+        size_t prefixBytes = 0;
+        bool ready = false;
+    };
+    std::vector<Slot> slots(window);
+    std::mutex m;
+    std::condition_variable cv;
+    uint64_t claimed = 0;   // next chunk to fill
+    uint64_t written = 0;   // chunks already passed to the sink
+    bool stop = false;
+
+    using Clock = std::chrono::steady_clock;
+    auto nanosSince = [](Clock::time_point t0) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+    };
+
+    auto worker = [&](size_t t) {
+        for (;;) {
+            uint64_t c;
+            {
+                std::unique_lock<std::mutex> lk(m);
+                if (claimed == chunks || stop) return;
+                c = claimed++;
+                const auto waiting = Clock::now();
+                cv.wait(lk, [&] { return stop || c < written + window; });   // slot c % window is free
+                if (metrics) ThreadMetrics::add(metrics->thread(t).waitNs, nanosSince(waiting));
+                if (stop) return;
+            }
+            const auto filling = Clock::now();
+            Slot& s = slots[c % window];
+            const size_t n = static_cast<size_t>(std::min(CODE_CHUNK, count - c * CODE_CHUNK));
+            const std::string stamp = lineTimestamps ? getCurrentTimestamp() + " " : std::string();
+            s.bytes.resize(Engine::fillBytes(n, stamp));
+            if (withKeys) s.keys.resize(n);
+            CodeRng rng(masterSeed, c);
+            s.used = Engine::fill(s.bytes.data(), n, rng, stamp, withKeys ? s.keys.data() : nullptr);
+            s.count = n;
+            s.prefixBytes = stamp.size();
+            if (metrics) {
+                ThreadMetrics& tm = metrics->thread(t);
+                tm.latency.record(nanosSince(filling));
+                ThreadMetrics::add(tm.codes, n);
+            }
+            {
+                std::lock_guard<std::mutex> lk(m);
+                s.ready = true;
+            }
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t) pool.emplace_back(worker, t);
+
+    bool ok = true;
+    for (uint64_t c = 0; c < chunks && ok; ++c) {
+        Slot& s = slots[c % window];
+        {
+            std::unique_lock<std::mutex> lk(m);
+            cv.wait(lk, [&] { return s.ready; });
+        }
+        ok = sink(OrderedChunk{c, s.bytes.data(), s.used, s.count, s.prefixBytes,
+                               withKeys ? s.keys.data() : nullptr});
+        {
+            std::lock_guard<std::mutex> lk(m);
+            s.ready = false;
+            written = c + 1;
+            stop = !ok;
+        }
+        cv.notify_all();
+    }
+    for (auto& t : pool) t.join();
+    return ok;
+}
@@ -0,0 +1,38 @@
+// code_rng.hpp
+// Fast per-thread randomness for the code generators, replacing rand().
+// wyrand (Wang Yi) is one 64-bit add and one 64x64->128 multiply per
+// draw, with no shared state — every thread or stream owns its own.
+#pragma once
+
+#include <cstdint>
+
+// splitmix64 finaliser: spreads (seed, stream) pairs across the state space.
+inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+class CodeRng {
+public:
+    explicit CodeRng(uint64_t seed, uint64_t stream = 0) : state_(splitmix64(seed ^ splitmix64(stream))) {}
+
+    uint64_t next() {
+        state_ += 0xA0761D6478BD642Full;
+        const unsigned __int128 t = static_cast<unsigned __int128>(state_) * (state_ ^ 0xE7037ED1A0B428DBull);
+        return static_cast<uint64_t>(t >> 64) ^ static_cast<uint64_t>(t);
+    }
+
+    // Uniform in [0, n): Lemire's multiply-shift with rejection of the biased sliver.
+    uint64_t below(uint64_t n) {
+        const uint64_t threshold = -n % n;
+        for (;;) {
+            const unsigned __int128 m = static_cast<unsigned __int128>(next()) * n;
+            if (static_cast<uint64_t>(m) >= threshold) return static_cast<uint64_t>(m >> 64);
+        }
+    }
+
+private:
+    uint64_t state_;
+};
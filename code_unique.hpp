@@ -0,0 +1,423 @@
+// code_unique.hpp
+// Guaranteed-unique issuance for the code generators (--unique FILE).
+// Every code is identified by its key (code_engine.hpp). Issued keys
+// live in a state file, so codes never repeat within a run or across
+// runs that share the file:
+//
+//   CodeBitset      one bit per possible code, mmap'd read-write. Used
+//                   when the key space is small enough — 10^8 digit codes
+//                   take 12.5 MB. Setting a bit is a write to the mapping.
+//   ShardedCodeSet  for letters (26^8) and emoji (50^8): 256 shards of
+//                   open-addressing uint64 tables with linear probing,
+//                   each grown on its own at half load, so a probe stays
+//                   about one cache line even near capacity. The file is
+//                   a key list; each chunk's new keys are appended.
+//
+// Checks run on the thread that writes the chunks, in chunk order, so
+// runs with the same seed and state file stay identical at any thread
+// count. Codes already issued are redrawn from the chunk's own
+// replacement stream. A chunk's keys are committed to the state file
+// before the chunk is written out, so a run that dies never leaves codes
+// out that the next run could issue again; a chunk that cannot be
+// completed is rolled back. One run at a time holds a state file
+// (flock); open() fails with busy() set while another run has it.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "code_engine.hpp"
+#include "code_parallel.hpp"
+#include "code_rng.hpp"
+
+struct CodeStateHeader {
+    char     magic[8];      // "CODEBIT\0" or "CODESET\0"
+    uint32_t alphabet;      // symbols per position
+    uint32_t length;        // symbols per code
+};
+
+// Opens a state file and takes its run-long exclusive lock; -1 on
+// failure, with `busy` set if another run holds the lock.
+inline int openLockedState(const std::string& path, int flags, bool& busy) {
+    busy = false;
+    const int fd = ::open(path.c_str(), flags | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return -1;
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        busy = errno == EWOULDBLOCK;
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// --- Bitset over the whole key space ---
+class CodeBitset {
+public:
+    static constexpr char MAGIC[8] = {'C', 'O', 'D', 'E', 'B', 'I', 'T', '\0'};
+
+    CodeBitset() = default;
+    CodeBitset(const CodeBitset&) = delete;
+    CodeBitset& operator=(const CodeBitset&) = delete;
+    ~CodeBitset() { close(); }
+
+    // Maps `path`, creating an empty bitset for `space` keys if it is missing.
+    bool open(const std::string& path, uint64_t space, uint32_t alphabet, uint32_t length) {
+        close();
+        const size_t bytes = sizeof(CodeStateHeader) + (space + 63) / 64 * 8;
+        fd_ = openLockedState(path, O_RDWR, busy_);   // held until close()
+        if (fd_ < 0) return false;
+        struct stat st{};
+        bool ok = fstat(fd_, &st) == 0;
+        const bool fresh = ok && st.st_size == 0;
+        if (ok && fresh) ok = ftruncate(fd_, bytes) == 0;
+        ok = ok && static_cast<size_t>(fresh ? bytes : st.st_size) == bytes;
+        void* p = ok ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0) : MAP_FAILED;
+        if (p == MAP_FAILED) return false;
+
+        auto* hdr = static_cast<CodeStateHeader*>(p);
+        if (fresh) {
+            std::memcpy(hdr->magic, MAGIC, sizeof(MAGIC));
+            hdr->alphabet = alphabet;
+            hdr->length = length;
+        } else if (std::memcmp(hdr->magic, MAGIC, sizeof(MAGIC)) != 0 || hdr->alphabet != alphabet ||
+                   hdr->length != length) {
+            munmap(p, bytes);
+            return false;
+        }
+        map_ = p;
+        mapSize_ = bytes;
+        words_ = reinterpret_cast<uint64_t*>(hdr + 1);
+        const size_t words = (space + 63) / 64;
+        for (size_t w = 0; w < words; ++w) size_ += __builtin_popcountll(words_[w]);
+        return true;
+    }
+
+    // True if `key` was not issued before (and now is).
+    bool insert(uint64_t key) {
+        uint64_t& w = words_[key >> 6];
+        const uint64_t bit = 1ULL << (key & 63);
+        if (w & bit) return false;
+        w |= bit;
+        ++size_;
+        pending_.push_back(key);
+        return true;
+    }
+    void prefetch(uint64_t key) const { __builtin_prefetch(&words_[key >> 6], 1); }
+    uint64_t size() const { return size_; }
+    bool busy() const { return busy_; }
+
+    // Bits set in the shared mapping are the kernel's once written, so a
+    // process that dies keeps them; close() syncs them to disk.
+    bool commit() {
+        pending_.clear();
+        return true;
+    }
+    // Clears the bits set since the last commit().
+    void rollback() {
+        for (uint64_t key : pending_) words_[key >> 6] &= ~(1ULL << (key & 63));
+        size_ -= pending_.size();
+        pending_.clear();
+    }
+
+    bool close() {
+        bool ok = true;
+        if (map_) {
+            ok = msync(map_, mapSize_, MS_SYNC) == 0;
+            munmap(map_, mapSize_);
+        }
+        if (fd_ >= 0) ::close(fd_);   // drops the lock
+        fd_ = -1;
+        map_ = nullptr;
+        words_ = nullptr;
+        size_ = 0;
+        pending_.clear();
+        return ok;
+    }
+
+private:
+    void*     map_     = nullptr;
+    size_t    mapSize_ = 0;
+    uint64_t* words_   = nullptr;
+    uint64_t  size_    = 0;
+    int       fd_      = -1;
+    bool      busy_    = false;
+    std::vector<uint64_t> pending_;   // keys inserted since the last commit()
+};
+
+// --- Sharded hash set of keys ---
+class ShardedCodeSet {
+public:
+    static constexpr char MAGIC[8] = {'C', 'O', 'D', 'E', 'S', 'E', 'T', '\0'};
+    static constexpr size_t SHARDS = 256;
+
+    ShardedCodeSet() = default;
+    ShardedCodeSet(const ShardedCodeSet&) = delete;
+    ShardedCodeSet& operator=(const ShardedCodeSet&) = delete;
+    ~ShardedCodeSet() { close(); }
+
+    // Loads the keys in `path`, or starts an empty set if it is missing.
+    bool open(const std::string& path, uint64_t /*space*/, uint32_t alphabet, uint32_t length) {
+        close();
+        for (auto& s : shards_) s.slots.assign(1024, 0);
+        CodeStateHeader hdr{};
+        std::memcpy(hdr.magic, MAGIC, sizeof(MAGIC));
+        hdr.alphabet = alphabet;
+        hdr.length = length;
+
+        fd_ = openLockedState(path, O_RDWR | O_APPEND, busy_);   // held until close()
+        struct stat st{};
+        if (fd_ < 0 || fstat(fd_, &st) != 0) return false;
+        size_t size = static_cast<size_t>(st.st_size);
+        if (size == 0) return writeAll(&hdr, sizeof(hdr)) && fsync(fd_) == 0;
+        if (size < sizeof(hdr)) return false;
+        if (const size_t partial = (size - sizeof(hdr)) % 8) {   // a run died mid-append
+            std::cerr << "Warning: " << path << " ends in a partial key; dropping its last " << partial
+                      << " bytes\n";
+            size -= partial;
+            if (ftruncate(fd_, static_cast<off_t>(size)) != 0) return false;
+        }
+
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED) return false;
+        madvise(p, size, MADV_SEQUENTIAL);
+        CodeStateHeader onDisk;
+        std::memcpy(&onDisk, p, sizeof(onDisk));
+        const bool ok = std::memcmp(&onDisk, &hdr, sizeof(hdr)) == 0;
+        if (ok) {
+            const char* keys = static_cast<const char*>(p) + sizeof(hdr);
+            for (size_t off = 0; off < size - sizeof(hdr); off += 8) {
+                uint64_t key;
+                std::memcpy(&key, keys + off, 8);
+                add(key);
+            }
+        }
+        munmap(p, size);
+        return ok;
+    }
+
+    bool insert(uint64_t key) {
+        if (!add(key)) return false;
+        fresh_.push_back(key);
+        return true;
+    }
+    bool busy() const { return busy_; }
+
+    // Appends the keys inserted since the last commit() to the state file
+    // and syncs it.
+    bool commit() {
+        if (fresh_.empty()) return true;
+        const bool ok = writeAll(fresh_.data(), fresh_.size() * 8) && fsync(fd_) == 0;
+        fresh_.clear();
+        return ok;
+    }
+    // Forgets the keys inserted since the last commit().
+    void rollback() {
+        for (uint64_t key : fresh_) erase(key);
+        fresh_.clear();
+    }
+    void prefetch(uint64_t key) const {
+        const uint64_t h = hash(key);
+        const Shard& s = shards_[h >> 56];
+        __builtin_prefetch(&s.slots[h & (s.slots.size() - 1)]);
+    }
+    uint64_t size() const { return size_; }
+
+    // Commits what is left and releases the state file.
+    bool close() {
+        bool ok = true;
+        if (fd_ >= 0) {
+            ok = commit();
+            ::close(fd_);   // drops the lock
+        }
+        fd_ = -1;
+        fresh_.clear();
+        for (auto& s : shards_) {
+            s.slots.clear();
+            s.used = 0;
+        }
+        size_ = 0;
+        return ok;
+    }
+
+private:
+    // Slots hold key + 1, so 0 marks an empty slot.
+    struct Shard {
+        std::vector<uint64_t> slots;
+        size_t used = 0;
+    };
+
+    static uint64_t hash(uint64_t key) {
+        const uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+        return h ^ (h >> 29);
+    }
+
+    bool add(uint64_t key) {
+        const uint64_t h = hash(key);
+        Shard& s = shards_[h >> 56];
+        if (2 * (s.used + 1) > s.slots.size()) grow(s);
+        const size_t mask = s.slots.size() - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            if (s.slots[i] == key + 1) return false;
+            if (s.slots[i] == 0) {
+                s.slots[i] = key + 1;
+                ++s.used;
+                ++size_;
+                return true;
+            }
+        }
+    }
+
+    // Backward-shift deletion keeps every probe run unbroken.
+    void erase(uint64_t key) {
+        const uint64_t h = hash(key);
+        Shard& s = shards_[h >> 56];
+        const size_t mask = s.slots.size() - 1;
+        size_t i = h & mask;
+        while (s.slots[i] != key + 1) {
+            if (s.slots[i] == 0) return;
+            i = (i + 1) & mask;
+        }
+        for (size_t j = (i + 1) & mask; s.slots[j]; j = (j + 1) & mask) {
+            const size_t home = hash(s.slots[j] - 1) & mask;
+            if (((j - home) & mask) >= ((j - i) & mask)) {   // slot i is on j's probe path
+                s.slots[i] = s.slots[j];
+                i = j;
+            }
+        }
+        s.slots[i] = 0;
+        --s.used;
+        --size_;
+    }
+
+    static void grow(Shard& s) {
+        std::vector<uint64_t> old(s.slots.size() * 2, 0);
+        old.swap(s.slots);
+        const size_t mask = s.slots.size() - 1;
+        for (uint64_t v : old) {
+            if (!v) continue;
+            size_t i = hash(v - 1) & mask;
+            while (s.slots[i]) i = (i + 1) & mask;
+            s.slots[i] = v;
+        }
+    }
+
+    bool writeAll(const void* data, size_t len) {
+        const char* p = static_cast<const char*>(data);
+        size_t off = 0;
+        while (off < len) {
+            ssize_t n = ::write(fd_, p + off, len - off);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            off += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    std::array<Shard, SHARDS> shards_;
+    std::vector<uint64_t> fresh_;   // keys inserted since the last commit()
+    uint64_t size_ = 0;
+    int fd_ = -1;
+    bool busy_ = false;
+};
+
+// Bitset when the whole key space fits in 2^30 bits (128 MB), else the hash set.
+template <class Alphabet, size_t Length>
+using UniqueCodeSet =
+    std::conditional_t<(codeKeySpace<Alphabet, Length>() <= (uint64_t(1) << 30)), CodeBitset, ShardedCodeSet>;
+
+// --- Filtering chunks ---
+// Passes chunks through unchanged unless one holds an issued code; that
+// chunk is rebuilt with the code redrawn from CodeRng(masterSeed, stream
+// 2^63 + chunk index). Fails once MAX_REDRAWS draws in a row hit issued
+// codes, i.e. when the style's code space is all but exhausted.
+template <class Engine, class Set>
+class UniqueChunkFilter {
+public:
+    static constexpr unsigned MAX_REDRAWS = 1 << 16;
+
+    UniqueChunkFilter(Set& set, uint64_t masterSeed) : set_(set), masterSeed_(masterSeed) {}
+
+    // Returns false on exhaustion, with the chunk's keys rolled back;
+    // otherwise (bytes, len) is the chunk to write and keys() the keys of
+    // its lines (the chunk needs withKeys). The caller commits the set
+    // before writing the chunk.
+    bool filter(const OrderedChunk& chunk, const char*& bytes, size_t& len) {
+        constexpr size_t AHEAD = 8;
+        fresh_.resize(chunk.count);
+        bool clean = true;
+        for (size_t i = 0; i < chunk.count; ++i) {
+            if (i + AHEAD < chunk.count) set_.prefetch(chunk.keys[i + AHEAD]);
+            fresh_[i] = set_.insert(chunk.keys[i]);
+            clean &= fresh_[i] != 0;
+        }
+        bytes = chunk.bytes;
+        len = chunk.len;
+        keys_ = chunk.keys;
+        if (clean) return true;
+
+        // Rebuild, redrawing every code that was issued before — in an
+        // earlier run, an earlier chunk or earlier in this one.
+        rebuilt_.resize(Engine::fillBytes(chunk.count) + chunk.count * chunk.prefixBytes);
+        rebuiltKeys_.assign(chunk.keys, chunk.keys + chunk.count);
+        CodeRng rng(masterSeed_, (uint64_t(1) << 63) | chunk.index);
+        const char* line = chunk.bytes;
+        char* out = rebuilt_.data();
+        for (size_t i = 0; i < chunk.count; ++i) {
+            const char* end = static_cast<const char*>(std::memchr(line, '\n', chunk.bytes + chunk.len - line));
+            if (fresh_[i]) {
+                std::memcpy(out, line, end + 1 - line);
+                out += end + 1 - line;
+            } else {
+                std::memcpy(out, line, chunk.prefixBytes);
+                out += chunk.prefixBytes;
+                if (!redraw(rng, out, rebuiltKeys_[i])) {
+                    set_.rollback();
+                    return false;
+                }
+                *out++ = '\n';
+            }
+            line = end + 1;
+        }
+        bytes = rebuilt_.data();
+        len = static_cast<size_t>(out - rebuilt_.data());
+        keys_ = rebuiltKeys_.data();
+        return true;
+    }
+    const uint64_t* keys() const { return keys_; }
+
+private:
+    bool redraw(CodeRng& rng, char*& out, uint64_t& key) {
+        std::array<uint8_t, Engine::LENGTH> idx;
+        for (unsigned tries = 0; tries < MAX_REDRAWS; ++tries) {
+            Engine::draw(idx, rng);
+            key = codeKey<typename Engine::Alphabet, Engine::LENGTH>(idx);
+            if (set_.insert(key)) {
+                out += Engine::render(idx, out);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Set& set_;
+    uint64_t masterSeed_;
+    std::vector<char> fresh_;     // first-pass insert() results
+    std::vector<char> rebuilt_;
+    std::vector<uint64_t> rebuiltKeys_;
+    const uint64_t* keys_ = nullptr;
+};
@@ -0,0 +1,239 @@
+// code_validate.cpp
+// ---------------------------------------------------------------
+// Bulk checksum validator for issued integer and string codes.
+// Takes integer.log / string.log (or any batch --out file, or raw
+// files of one code per line), maps it, and checks the trailing
+// checksum symbol of every 8-symbol checksum code:
+//
+//   digits   last = (d0 + … + d6) mod 10
+//   letters  last = 'A' + (c0 + … + c6) mod 26     (character codes)
+//
+// The file is split at line boundaries across threads. A code is
+// checked in a few 64-bit SWAR operations: one range test over all 8
+// bytes and one multiply to add up the first 7. In logs only codes
+// from style 2 (Checksum) sessions are checked; files without session
+// headers are treated as checksum codes throughout. A chunk that
+// starts mid-session defers its leading codes until the session style
+// from the chunks before it is known.
+// ---------------------------------------------------------------
+// Build:   g++ -std=c++17 -O2 -pthread code_validate.cpp -o code_validate
+// Run:     ./code_validate FILE [--threads T] [--all] [--report N]
+//   threads = worker threads                         (default: all cores)
+//   all     = check every 8-symbol code, whatever its session's style
+//   report  = invalid lines to print                 (default 20)
+// Exit status is 1 when any code fails its checksum.
+// ---------------------------------------------------------------
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "code_alphabets.hpp"
+
+// ───────────────────────────── SWAR checks ─────────────────────────────────
+constexpr uint64_t ONES = 0x0101010101010101ULL;
+constexpr uint64_t HIGH = 0x8080808080808080ULL;
+
+enum class CodeCheck { NotACode, Valid, Invalid };
+
+// Every byte in [lo, hi] (both < 0x80).
+inline bool bytesInRange(uint64_t v, unsigned lo, unsigned hi) {
+    const uint64_t geLo = v + ONES * (0x80 - lo);
+    const uint64_t gtHi = v + ONES * (0x80 - hi - 1);
+    return ((v & HIGH) | (~geLo & HIGH) | (gtHi & HIGH)) == 0;
+}
+
+template <class Alphabet>
+inline CodeCheck checkCode(uint64_t v, char first) {
+    if (!bytesInRange(v, first, first + Alphabet::SIZE - 1)) return CodeCheck::NotACode;
+    const uint64_t idx = v - ONES * static_cast<uint8_t>(first);
+    const unsigned sum = static_cast<unsigned>(((idx & 0x00FFFFFFFFFFFFFFULL) * ONES) >> 56);
+    const unsigned expected = (sum + Alphabet::CHECKSUM_BIAS * 7) % Alphabet::SIZE;
+    return (idx >> 56) == expected ? CodeCheck::Valid : CodeCheck::Invalid;
+}
+
+inline CodeCheck checkCode(const char* code) {
+    uint64_t v;
+    std::memcpy(&v, code, 8);
+    if (static_cast<uint8_t>(code[0]) <= '9') return checkCode<DigitAlphabet>(v, '0');
+    return checkCode<LetterAlphabet>(v, 'A');
+}
+
+// ───────────────────────────── per-chunk scan ───────────────────────────────
+struct BadLine {
+    size_t offset;   // byte offset of the line
+    size_t line;     // line index within the chunk (made global later)
+};
+
+struct ChunkResult {
+    // codes before the chunk's first session header: their style is inherited
+    size_t deferredChecked = 0;
+    std::vector<BadLine> deferredBad;
+    // codes after it
+    size_t checked = 0;
+    std::vector<BadLine> bad;
+    size_t skipped = 0;           // codes in non-checksum sessions
+    size_t lines = 0;
+    int lastStyle = 0;            // style of the last header in the chunk, 0 = none
+};
+
+constexpr int NO_SESSION = 0;
+
+// Session header lines end in "--- Session Start: Generating N x with style K ---".
+inline int headerStyle(const char* line, size_t len) {
+    static const char KEY[] = "with style ";
+    const char* p = static_cast<const char*>(memmem(line, len, KEY, sizeof(KEY) - 1));
+    if (!p || !memmem(line, len, "Session Start", 13)) return -1;
+    return std::atoi(p + sizeof(KEY) - 1);
+}
+
+void scanChunk(const char* base, size_t begin, size_t end, bool all, ChunkResult& r) {
+    int style = NO_SESSION;        // NO_SESSION until this chunk sees a header
+    const char* p = base + begin;
+    const char* stop = base + end;
+    while (p < stop) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', stop - p));
+        const char* lineEnd = nl ? nl : stop;
+        size_t len = static_cast<size_t>(lineEnd - p);
+        if (len && p[len - 1] == '\r') --len;
+
+        if (len >= 8 && (len == 8 || p[len - 9] == ' ')) {
+            const int hs = len > 30 ? headerStyle(p, len) : -1;
+            if (hs >= 0) {
+                style = hs;
+                r.lastStyle = hs;
+            } else {
+                const CodeCheck c = checkCode(p + len - 8);
+                if (c != CodeCheck::NotACode) {
+                    const bool deferred = r.lastStyle == NO_SESSION;
+                    if (!all && !deferred && style != 2) {
+                        ++r.skipped;
+                    } else if (deferred) {
+                        ++r.deferredChecked;
+                        if (c == CodeCheck::Invalid) r.deferredBad.push_back({static_cast<size_t>(p - base), r.lines});
+                    } else {
+                        ++r.checked;
+                        if (c == CodeCheck::Invalid) r.bad.push_back({static_cast<size_t>(p - base), r.lines});
+                    }
+                }
+            }
+        } else if (len > 30) {
+            const int hs = headerStyle(p, len);
+            if (hs >= 0) {
+                style = hs;
+                r.lastStyle = hs;
+            }
+        }
+        ++r.lines;
+        p = lineEnd + 1;
+    }
+}
+
+// ──────────────────────────────── main ──────────────────────────────────────
+int main(int argc, char* argv[]) {
+    std::string path;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t report = 20;
+    bool all = false;
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        if (arg == "--threads" && a + 1 < argc)     threads = std::max(1, std::atoi(argv[++a]));
+        else if (arg == "--report" && a + 1 < argc) report = std::strtoull(argv[++a], nullptr, 10);
+        else if (arg == "--all")                    all = true;
+        else if (path.empty() && arg[0] != '-')     path = arg;
+        else {
+            std::cerr << "Usage: ./code_validate FILE [--threads T] [--all] [--report N]\n";
+            return 1;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "Usage: ./code_validate FILE [--threads T] [--all] [--report N]\n";
+        return 1;
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat st{};
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        std::cerr << "Cannot open " << path << "\n";
+        return 1;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    const char* base = nullptr;
+    if (size) {
+        void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            std::cerr << "Cannot map " << path << "\n";
+            return 1;
+        }
+        madvise(map, size, MADV_SEQUENTIAL);
+        base = static_cast<const char*>(map);
+    }
+    ::close(fd);
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    // chunk boundaries just after a '\n'
+    threads = std::max<size_t>(1, std::min(threads, size / (1 << 16) + 1));
+    std::vector<size_t> cut{0};
+    for (size_t t = 1; t < threads; ++t) {
+        size_t at = std::max(cut.back(), size * t / threads);
+        const void* nl = at < size ? std::memchr(base + at, '\n', size - at) : nullptr;
+        at = nl ? static_cast<size_t>(static_cast<const char*>(nl) - base) + 1 : size;
+        cut.push_back(at);
+    }
+    cut.push_back(size);
+
+    std::vector<ChunkResult> results(threads);
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back(scanChunk, base, cut[t], cut[t + 1], all, std::ref(results[t]));
+    }
+    for (auto& th : pool) th.join();
+
+    // stitch: resolve deferred codes with the style carried in from earlier chunks
+    size_t checked = 0, skipped = 0, invalid = 0, lines = 0, printed = 0;
+    int style = NO_SESSION;
+    auto emit = [&](const std::vector<BadLine>& bad) {
+        for (const BadLine& b : bad) {
+            ++invalid;
+            if (printed++ >= report) continue;
+            const char* line = base + b.offset;
+            const char* nl = static_cast<const char*>(std::memchr(line, '\n', size - b.offset));
+            std::cout << "invalid at offset " << b.offset << " (line " << lines + b.line + 1 << "): "
+                      << std::string(line, nl ? nl : base + size) << "\n";
+        }
+    };
+    for (const ChunkResult& r : results) {
+        // no header before this point means a raw code file: check everything
+        if (all || style == NO_SESSION || style == 2) {
+            checked += r.deferredChecked;
+            emit(r.deferredBad);
+        } else {
+            skipped += r.deferredChecked;
+        }
+        checked += r.checked;
+        skipped += r.skipped;
+        emit(r.bad);
+        lines += r.lines;
+        if (r.lastStyle != NO_SESSION) style = r.lastStyle;
+    }
+
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (printed > report) std::cout << "... " << printed - report << " more invalid lines not shown\n";
+    std::cerr << path << ": " << checked << " codes checked, " << invalid << " invalid, " << skipped
+              << " skipped (non-checksum sessions), " << lines << " lines, "
+              << (sec > 0 ? size / sec / 1e6 : 0) << " MB/s on " << threads << " threads\n";
+
+    if (base) munmap(const_cast<char*>(base), size);
+    return invalid ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+// codegen.cpp
+// ---------------------------------------------------------------
+// libcodegen: the C interface of codegen.h over the same engines the
+// programs use — CodeEngine with CodeRng(seed, chunk) per CODE_CHUNK
+// codes (code_parallel.hpp), and the counter‑based rain walk
+// (rain_rng.hpp) tested by the sieved bitmap or Miller–Rabin.
+// Nothing here keeps state between calls except the bitmaps mapped by
+// prime_rain_load_bitmap(), so calls may run concurrently.
+// ---------------------------------------------------------------
+// Build:   see codegen.h (static archive or shared object)
+// ---------------------------------------------------------------
+
+#include "codegen.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "code_engine.hpp"
+#include "code_parallel.hpp"
+#include "hop_journal.hpp"
+#include "primality.hpp"
+#include "prime_bitmap.hpp"
+#include "rain_rng.hpp"
+
+namespace {
+
+// Runs work(begin, end) over [0, units) cut into `threads` contiguous
+// parts, the first on the calling thread. Parts whose thread cannot be
+// started (resource limits) run on the calling thread too: nothing may
+// throw across the C interface.
+template <class Work>
+void splitWork(uint64_t units, unsigned threads, Work&& work) {
+    const uint64_t parts = std::max<uint64_t>(1, std::min<uint64_t>(threads, units));
+    if (parts == 1) {
+        work(uint64_t(0), units);
+        return;
+    }
+    std::vector<std::thread> pool;
+    uint64_t started = 1;
+    try {
+        pool.reserve(parts - 1);
+        for (; started < parts; ++started) {
+            pool.emplace_back(work, units * started / parts, units * (started + 1) / parts);
+        }
+    } catch (const std::exception&) {}
+    work(uint64_t(0), units / parts);
+    for (uint64_t t = started; t < parts; ++t) work(units * t / parts, units * (t + 1) / parts);
+    for (auto& th : pool) th.join();
+}
+
+// Calls f(Engine{}) for the alphabet number; false if it is unknown.
+template <class F>
+bool withAlphabet(int style, int alphabet, F&& f) {
+    switch (alphabet) {
+        case CODEGEN_LETTERS: return withCodeStyle<LetterAlphabet>(style, f);
+        case CODEGEN_DIGITS:  return withCodeStyle<DigitAlphabet>(style, f);
+        case CODEGEN_EMOJI:   return withCodeStyle<EmojiAlphabet>(style, f);
+    }
+    return false;
+}
+
+// Codes of chunks [c0, c1); chunk c is CodeRng(seed, c), as in generateOrdered.
+template <class Engine>
+void fillChunks(uint64_t c0, uint64_t c1, size_t n, char* out, size_t stride, uint64_t seed) {
+    char code[Engine::BUFFER_BYTES];
+    for (uint64_t c = c0; c < c1; ++c) {
+        CodeRng rng(seed, c);
+        const uint64_t end = std::min<uint64_t>(n, (c + 1) * CODE_CHUNK);
+        for (uint64_t i = c * CODE_CHUNK; i < end; ++i) {
+            const size_t len = Engine::generate(code, rng);
+            char* slot = out + i * stride;
+            std::memcpy(slot, code, len);
+            slot[len] = '\0';
+        }
+    }
+}
+
+// ──────────────────────────── prime rain ────────────────────────────────────
+constexpr int MAX_BITMAP_DIGITS = 9;   // the widest range that fits 32 bits
+
+PrimeBitmap                      rainBitmaps[MAX_BITMAP_DIGITS + 1];
+std::atomic<const PrimeBitmap*>  rainBitmapFor[MAX_BITMAP_DIGITS + 1];
+std::mutex                       rainBitmapMutex;
+
+bool digitRange(int digits, uint64_t& lower, uint64_t& upper) {
+    if (digits < 2 || digits > 19) return false;
+    lower = 1;
+    for (int d = 1; d < digits; ++d) lower *= 10;
+    upper = lower * 10 - 1;
+    return true;
+}
+
+}  // namespace
+
+extern "C" {
+
+unsigned codegen_abi_version(void) { return CODEGEN_ABI_VERSION; }
+
+size_t codegen_max_bytes(int style, int alphabet) {
+    size_t bytes = 0;
+    withAlphabet(style, alphabet, [&](auto engine) { bytes = decltype(engine)::MAX_BYTES; });
+    return bytes;
+}
+
+int codegen_fill(int style, int alphabet, size_t n, char* out, size_t stride, uint64_t seed, unsigned threads) {
+    const size_t maxBytes = codegen_max_bytes(style, alphabet);
+    if (maxBytes == 0 || (!out && n)) return CODEGEN_EINVAL;
+    if (stride < maxBytes + 1) return CODEGEN_ESTRIDE;
+    withAlphabet(style, alphabet, [&](auto engine) {
+        using Engine = decltype(engine);
+        splitWork((n + CODE_CHUNK - 1) / CODE_CHUNK, threads,
+                  [&](uint64_t c0, uint64_t c1) { fillChunks<Engine>(c0, c1, n, out, stride, seed); });
+    });
+    return CODEGEN_OK;
+}
+
+int prime_rain_load_bitmap(int digits, const char* path, unsigned threads) {
+    uint64_t lower, upper;
+    if (!digitRange(digits, lower, upper) || digits > MAX_BITMAP_DIGITS) return CODEGEN_EINVAL;
+    std::lock_guard<std::mutex> lk(rainBitmapMutex);
+    if (rainBitmapFor[digits].load(std::memory_order_acquire)) return CODEGEN_OK;
+    const auto lo = static_cast<uint32_t>(lower), hi = static_cast<uint32_t>(upper);
+    PrimeBitmap& bitmap = rainBitmaps[digits];
+    try {
+        if (!bitmap.loadOrBuild(path ? path : PrimeBitmap::defaultPath(lo, hi), lo, hi, std::max(1u, threads))) {
+            return CODEGEN_EBITMAP;
+        }
+    } catch (const std::exception&) {                   // e.g. bad_alloc while sieving
+        return CODEGEN_EBITMAP;
+    }
+    rainBitmapFor[digits].store(&bitmap, std::memory_order_release);
+    return CODEGEN_OK;
+}
+
+int prime_rain_fill(uint64_t* out, size_t n, int digits, uint64_t master_seed, uint64_t first_seed,
+                    unsigned threads) {
+    uint64_t lower, upper;
+    if (!digitRange(digits, lower, upper) || (!out && n)) return CODEGEN_EINVAL;
+    const PrimeBitmap* bitmap =
+        digits <= MAX_BITMAP_DIGITS ? rainBitmapFor[digits].load(std::memory_order_acquire) : nullptr;
+    const RainRng rng(master_seed, lower, upper);
+
+    // the hop‑by‑hop walk of prime_rain --replay
+    splitWork(n, threads, [&](uint64_t begin, uint64_t end) {
+        for (uint64_t i = begin; i < end; ++i) {
+            const uint64_t seed = first_seed + i;
+            uint64_t p = rng.start(seed);
+            for (uint64_t hop = 1; !(bitmap ? bitmap->test(static_cast<uint32_t>(p)) : isPrime64(p)); ++hop) {
+                const RainStep step = rng.step(seed, hop);
+                p = rainHop(p, step.delta, step.add, lower, upper);
+            }
+            out[i] = p;
+        }
+    });
+    return CODEGEN_OK;
+}
+
+}  // extern "C"
@@ -0,0 +1,83 @@
+/* codegen.h
+ * ---------------------------------------------------------------
+ * C interface to the code generators and prime rain, for programs
+ * that would otherwise spawn ./string, ./integer, ./emoji or
+ * ./prime_rain and parse their output. Every call fills a buffer the
+ * caller owns; with threads ≤ 1 it runs on the calling thread and
+ * allocates nothing, with more it splits the batch over that many
+ * threads and gives the same results.
+ *
+ * Results match the programs: codegen_fill(style, alphabet, n, …, seed)
+ * gives the codes of `string|integer|emoji --style S --count n --seed
+ * seed --timestamps session`, and prime_rain_fill(…, digits, seed, 0,
+ * …) the primes of seeds #1…#n of `prime_rain --digits D --seed seed`.
+ *
+ * Functions return CODEGEN_OK (0) or a negative CODEGEN_E* code. The
+ * ABI only grows: codegen_abi_version() tells which calls exist.
+ * ---------------------------------------------------------------
+ * Build (static):  g++ -std=c++17 -O2 -pthread -fvisibility=hidden -c codegen.cpp -o codegen.o
+ *                  ar rcs libcodegen.a codegen.o
+ * Build (shared):  g++ -std=c++17 -O2 -pthread -fvisibility=hidden -fPIC -shared codegen.cpp -o libcodegen.so
+ * Link:            cc app.c -L. -lcodegen -lstdc++ -lpthread   (static)
+ * ---------------------------------------------------------------
+ */
+#ifndef CODEGEN_H
+#define CODEGEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define CODEGEN_API
+#else
+#define CODEGEN_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CODEGEN_ABI_VERSION 1
+
+enum {
+    CODEGEN_OK         = 0,
+    CODEGEN_EINVAL     = -1,   /* unknown style / alphabet, null buffer, bad digit width */
+    CODEGEN_ESTRIDE    = -2,   /* stride smaller than codegen_max_bytes() + 1 */
+    CODEGEN_EBITMAP    = -3    /* prime bitmap could not be loaded or built */
+};
+
+/* Alphabets: the symbol sets of the string, integer and emoji programs. */
+enum {
+    CODEGEN_LETTERS = 0,       /* A-Z      (string)  */
+    CODEGEN_DIGITS  = 1,       /* 0-9      (integer) */
+    CODEGEN_EMOJI   = 2        /* UTF-8    (emoji)   */
+};
+
+CODEGEN_API unsigned codegen_abi_version(void);
+
+/* Longest code of `style` (1..5) over `alphabet` in bytes, without the
+ * terminating NUL; 0 for an unknown style or alphabet. */
+CODEGEN_API size_t codegen_max_bytes(int style, int alphabet);
+
+/* Writes codes 0..n-1 as NUL-terminated strings at out, out + stride,
+ * out + 2·stride, …; stride must be at least codegen_max_bytes() + 1.
+ * Bytes after a code's NUL are left untouched. */
+CODEGEN_API int codegen_fill(int style, int alphabet, size_t n, char* out, size_t stride, uint64_t seed,
+                             unsigned threads);
+
+/* Makes prime_rain_fill test primality with the sieved bitmap for
+ * `digits` (2..9): maps `path`, building it there first if needed
+ * (null: prime_bitmap_<lower>_<upper>.bin in the working directory).
+ * Without it every width uses Miller-Rabin; the primes are the same. */
+CODEGEN_API int prime_rain_load_bitmap(int digits, const char* path, unsigned threads);
+
+/* out[i] = the prime that seed first_seed + i (0-based) rains down to
+ * for `digits`-digit numbers (2..19) under `master_seed`. */
+CODEGEN_API int prime_rain_fill(uint64_t* out, size_t n, int digits, uint64_t master_seed, uint64_t first_seed,
+                                unsigned threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CODEGEN_H */
@@ -0,0 +1,207 @@
+// hop_journal.hpp
+// ---------------------------------------------------------------
+// Compact binary hop journal for prime rain — the fast alternative to
+// the one‑text‑line‑per‑hop prime_rain_log.txt.
+//
+//   file   = JournalFileHeader, then blocks until EOF
+//   block  = JournalBlockHeader { magic, payload bytes, CRC‑32 } + payload
+//   stream = the concatenated block payloads, a sequence of records
+//   record = varint seed index, varint worker, varint original,
+//            varint hops, hops × signed delta, varint final prime
+//
+// Varints are LEB128. A signed delta keeps its sign in bit 0 of the
+// first byte next to the low 6 bits of |delta|, so even 19‑digit
+// deltas fit without a 65th bit. Blocks are integrity frames only;
+// a record may continue in the next block.
+// prime_rain_dump turns a journal back into the text log format.
+// ---------------------------------------------------------------
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ─────────────────── the walk's wrap rule (shared with the decoder) ───────────────────
+// n ± delta, wrapped back into [lower, upper].
+inline uint64_t rainHop(uint64_t n, uint64_t delta, bool add, uint64_t lower, uint64_t upper) {
+    const uint64_t span   = upper - lower + 1;
+    const uint64_t step   = delta % span;
+    uint64_t       offset = n - lower;
+    if (add) offset = (offset >= span - step) ? offset - (span - step) : offset + step;
+    else     offset = (offset >= step) ? offset - step : offset + (span - step);
+    return offset + lower;
+}
+
+// ─────────────────────────────── on‑disk layout ───────────────────────────────
+struct JournalFileHeader {
+    char     magic[8];      // "PRJRNL1\0"
+    uint32_t version;
+    uint32_t digits;
+    uint64_t lower;
+    uint64_t upper;
+    uint64_t seeds;
+    uint32_t threads;
+    uint32_t reserved;
+    uint64_t masterSeed;    // rain_rng.hpp key, for --replay
+};
+
+struct JournalBlockHeader {
+    uint32_t magic;         // JOURNAL_BLOCK_MAGIC
+    uint32_t bytes;         // payload size
+    uint32_t crc;           // CRC‑32 of the payload
+    uint32_t reserved;
+};
+
+constexpr char     JOURNAL_MAGIC[8]    = {'P', 'R', 'J', 'R', 'N', 'L', '1', '\0'};
+constexpr uint32_t JOURNAL_VERSION     = 2;
+constexpr uint32_t JOURNAL_BLOCK_MAGIC = 0x4B4C4250;   // "PBLK"
+
+// ─────────────────────────────── CRC‑32 (zlib) ────────────────────────────────
+inline uint32_t crc32(const void* data, size_t len, uint32_t crc = 0) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    const auto* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// ─────────────────────────────── varint encoding ──────────────────────────────
+inline void putVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out += static_cast<char>(v | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+inline void putSignedDelta(std::string& out, uint64_t magnitude, bool negative) {
+    uint64_t rest = magnitude >> 6;
+    char first = static_cast<char>(((magnitude & 0x3F) << 1) | (negative ? 1 : 0) | (rest ? 0x80 : 0));
+    out += first;
+    if (rest) putVarint(out, rest);
+}
+
+// Cursor over the record stream; every getter fails cleanly at the end,
+// so a record cut off by a block boundary simply reads as incomplete.
+class JournalCursor {
+public:
+    JournalCursor(const unsigned char* p, size_t len) : p_(p), end_(p + len) {}
+
+    const unsigned char* position() const { return p_; }
+    size_t remaining() const { return static_cast<size_t>(end_ - p_); }
+
+    bool getVarint(uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p_ == end_) return false;
+            const unsigned char b = *p_++;
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool getSignedDelta(uint64_t& magnitude, bool& negative) {
+        if (p_ == end_) return false;
+        const unsigned char b = *p_++;
+        negative  = b & 1;
+        magnitude = (b >> 1) & 0x3F;
+        if (!(b & 0x80)) return true;
+        uint64_t rest;
+        if (!getVarint(rest)) return false;
+        magnitude |= rest << 6;
+        return true;
+    }
+
+private:
+    const unsigned char* p_;
+    const unsigned char* end_;
+};
+
+// ─────────────────────────────── records ──────────────────────────────────────
+struct JournalRecord {
+    uint64_t seed     = 0;  // 0‑based seed index
+    uint64_t worker   = 0;
+    uint64_t original = 0;
+    uint64_t prime    = 0;
+    std::vector<std::pair<uint64_t, bool>> deltas;   // (|delta|, negative)
+};
+
+// Builds one record; hop deltas are collected first because the hop
+// count precedes them in the encoding.
+class JournalRecordBuilder {
+public:
+    void begin(uint64_t seed, uint64_t worker, uint64_t original) {
+        seed_ = seed;
+        worker_ = worker;
+        original_ = original;
+        hops_ = 0;
+        deltas_.clear();
+    }
+
+    void hop(uint64_t magnitude, bool negative) {
+        putSignedDelta(deltas_, magnitude, negative);
+        ++hops_;
+    }
+
+    void finish(std::string& out, uint64_t prime) const {
+        putVarint(out, seed_);
+        putVarint(out, worker_);
+        putVarint(out, original_);
+        putVarint(out, hops_);
+        out += deltas_;
+        putVarint(out, prime);
+    }
+
+private:
+    uint64_t seed_ = 0, worker_ = 0, original_ = 0, hops_ = 0;
+    std::string deltas_;
+};
+
+inline bool readJournalRecord(JournalCursor& cur, JournalRecord& rec) {
+    uint64_t hops;
+    if (!cur.getVarint(rec.seed) || !cur.getVarint(rec.worker) ||
+        !cur.getVarint(rec.original) || !cur.getVarint(hops)) return false;
+    if (hops > cur.remaining()) return false;                  // each delta takes ≥ 1 byte
+    rec.deltas.resize(hops);
+    for (auto& d : rec.deltas) {
+        if (!cur.getSignedDelta(d.first, d.second)) return false;
+    }
+    return cur.getVarint(rec.prime);
+}
+
+inline std::string journalBlockHeader(const char* payload, size_t len) {
+    JournalBlockHeader bh{JOURNAL_BLOCK_MAGIC, static_cast<uint32_t>(len), crc32(payload, len), 0};
+    return std::string(reinterpret_cast<const char*>(&bh), sizeof(bh));
+}
+
+// Renders a record exactly like the text log (worker index as the thread tag).
+inline void formatJournalRecord(std::string& out, const JournalRecord& rec, uint64_t lower, uint64_t upper) {
+    char line[128];
+    std::snprintf(line, sizeof(line), "Seed #%llu (thread %llu) : %llu\n",
+                  static_cast<unsigned long long>(rec.seed + 1), static_cast<unsigned long long>(rec.worker),
+                  static_cast<unsigned long long>(rec.original));
+    out += line;
+    uint64_t n = rec.original;
+    size_t hops = 0;
+    for (const auto& d : rec.deltas) {
+        n = rainHop(n, d.first, !d.second, lower, upper);
+        std::snprintf(line, sizeof(line), "  hop %4zu: ±%llu -> %llu\n", ++hops,
+                      static_cast<unsigned long long>(d.first), static_cast<unsigned long long>(n));
+        out += line;
+    }
+    std::snprintf(line, sizeof(line), "  prime reached after %zu hops: %llu\n\n", hops,
+                  static_cast<unsigned long long>(rec.prime));
+    out += line;
+}
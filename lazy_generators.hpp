@@ -0,0 +1,291 @@
+// lazy_generators.hpp
+// ---------------------------------------------------------------
+// Prime rain and the five code styles as pull‑based C++20 coroutines,
+// for programs that want the values in‑process instead of running a
+// binary and parsing its output:
+//
+//   rainDrops(arena, seed)              seed index 0, 1, … → RainResult
+//   codes<Alphabet>(arena, style, seed)  one code per item (string_view)
+//   codeLines<Alphabet>(arena, style, seed, perBlock)
+//                                        blocks of "code\n" lines
+//
+// Nothing runs ahead of the consumer: each next() resumes the coroutine
+// for exactly one item, and take(out, max) pulls up to max at once.
+// A string_view item points into the coroutine's own buffer and stays
+// valid until the next pull.
+//
+// Frames come from a caller‑supplied FrameArena (a bump allocator over
+// the caller's buffer), so creating a generator never touches the heap
+// and pulling items allocates nothing at all. A full arena yields an
+// empty generator (operator bool is false) rather than an exception;
+// codeLines also ends at once if its block buffer does not fit. An
+// arena serves one thread; frames are a few hundred bytes.
+//
+// Values match the programs: rainDrops walks each seed exactly like
+// `prime_rain --seed S` (same digits, same bitmap / Miller–Rabin test;
+// call setRainDigits / loadRainBitmap first to change them).
+// RainResult::seed is the 0-based seed index; the logs, --replay and
+// codegen.h count from 1, so index i is "Seed #i+1" there. The
+// codes of a given seed are those of `string|integer|emoji --style N
+// --seed S --timestamps session`.
+// ---------------------------------------------------------------
+// Build:   g++ -std=c++20 -O2 -pthread your_program.cpp
+// ---------------------------------------------------------------
+#pragma once
+
+#if __cplusplus < 202002L
+#error "lazy_generators.hpp needs C++20 coroutines (-std=c++20)"
+#endif
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+#include "code_engine.hpp"
+#include "code_parallel.hpp"
+#include "prime_rain.hpp"
+
+// ───────────────────────────── frame arena ──────────────────────────────────
+// Bump allocation over a caller buffer. Blocks freed in reverse order
+// give their space straight back, and the whole buffer is reused once
+// nothing is live, so a loop that creates and drops generators stays in
+// place.
+class FrameArena {
+public:
+    static constexpr size_t ALIGN = alignof(std::max_align_t);
+
+    FrameArena(void* buffer, size_t bytes) : base_(static_cast<char*>(buffer)), size_(bytes) {
+        const size_t skew = reinterpret_cast<uintptr_t>(base_) % ALIGN;
+        if (skew) {
+            const size_t pad = ALIGN - skew;
+            base_ += pad;
+            size_ = size_ > pad ? size_ - pad : 0;
+        }
+    }
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // null when the arena is full.
+    void* allocate(size_t bytes) {
+        bytes = (bytes + ALIGN - 1) / ALIGN * ALIGN;
+        if (bytes > size_ - top_) return nullptr;
+        void* p = base_ + top_;
+        top_ += bytes;
+        ++live_;
+        return p;
+    }
+
+    void release(void* p, size_t bytes) {
+        bytes = (bytes + ALIGN - 1) / ALIGN * ALIGN;
+        if (static_cast<char*>(p) + bytes == base_ + top_) top_ -= bytes;
+        if (--live_ == 0) top_ = 0;
+    }
+
+    size_t used() const { return top_; }
+    size_t capacity() const { return size_; }
+
+private:
+    char*  base_;
+    size_t size_;
+    size_t top_  = 0;
+    size_t live_ = 0;
+};
+
+// An arena block owned by a coroutine frame: handed back when the frame
+// is destroyed, finished or not.
+struct ArenaBlock {
+    FrameArena& arena;
+    void*       data;
+    size_t      bytes;
+
+    ArenaBlock(FrameArena& a, size_t n) : arena(a), data(a.allocate(n)), bytes(n) {}
+    ArenaBlock(const ArenaBlock&) = delete;
+    ArenaBlock& operator=(const ArenaBlock&) = delete;
+    ~ArenaBlock() {
+        if (data) arena.release(data, bytes);
+    }
+};
+
+// ───────────────────────────── generator<T> ─────────────────────────────────
+// Every coroutine returning Generator<T> takes its FrameArena& as the
+// first parameter; the frame is placed there, preceded by the arena
+// pointer so it can be given back.
+template <class T>
+class Generator {
+public:
+    struct promise_type {
+        T value{};
+
+        static constexpr size_t HEADER = FrameArena::ALIGN;
+
+        template <class... Args>
+        static void* operator new(size_t bytes, FrameArena& arena, Args&&...) noexcept {
+            char* p = static_cast<char*>(arena.allocate(bytes + HEADER));
+            if (!p) return nullptr;
+            *reinterpret_cast<FrameArena**>(p) = &arena;
+            return p + HEADER;
+        }
+        static void operator delete(void* frame, size_t bytes) noexcept {
+            char* p = static_cast<char*>(frame) - HEADER;
+            (*reinterpret_cast<FrameArena**>(p))->release(p, bytes + HEADER);
+        }
+        static Generator get_return_object_on_allocation_failure() noexcept { return Generator(); }
+
+        Generator get_return_object() noexcept {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(T v) noexcept {
+            value = std::move(v);
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    Generator() = default;
+    Generator(Generator&& o) noexcept : h_(std::exchange(o.h_, nullptr)) {}
+    Generator& operator=(Generator&& o) noexcept {
+        if (this != &o) {
+            if (h_) h_.destroy();
+            h_ = std::exchange(o.h_, nullptr);
+        }
+        return *this;
+    }
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+    ~Generator() {
+        if (h_) h_.destroy();
+    }
+
+    // False if the frame did not fit in the arena (or after a move).
+    explicit operator bool() const { return static_cast<bool>(h_); }
+
+    // Produces one item; false once the sequence is over.
+    bool next(T& out) {
+        if (!h_ || h_.done()) return false;
+        h_.resume();
+        if (h_.done()) return false;
+        out = h_.promise().value;
+        return true;
+    }
+
+    // Produces up to `max` items into out; fewer only at the end. For
+    // string_view items only the last stays valid — pull code batches
+    // through codeLines instead.
+    size_t take(T* out, size_t max) {
+        size_t n = 0;
+        while (n < max && next(out[n])) ++n;
+        return n;
+    }
+
+    // for (const T& v : gen) — pulls as the loop advances.
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const T*;
+        using reference         = const T&;
+
+        iterator() = default;
+        explicit iterator(Generator* g) : g_(g) { ++*this; }
+        reference operator*() const { return value_; }
+        pointer operator->() const { return &value_; }
+        iterator& operator++() {
+            if (!g_->next(value_)) g_ = nullptr;
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(const iterator& o) const { return g_ == o.g_; }
+        bool operator!=(const iterator& o) const { return g_ != o.g_; }
+
+    private:
+        Generator* g_ = nullptr;
+        T          value_{};
+    };
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+    explicit Generator(std::coroutine_handle<promise_type> h) : h_(h) {}
+
+    std::coroutine_handle<promise_type> h_ = nullptr;
+};
+
+// ───────────────────────────── prime rain ───────────────────────────────────
+// Seed indices first, first+1, … (count of them, or without end if 0),
+// each walked hop by hop to its prime under `masterSeed`. Indices are
+// 0-based: index i is "Seed #i+1" in the prime_rain log.
+inline Generator<RainResult> rainDrops(FrameArena&, uint64_t masterSeed, uint64_t first = 0, uint64_t count = 0) {
+    const RainRng rng(masterSeed, LOWER, UPPER);
+    for (uint64_t seed = first; count == 0 || seed - first < count; ++seed) {
+        uint64_t n = rng.start(seed);
+        uint64_t hops = 0;
+        while (!isPrime(n)) {
+            const RainStep step = rng.step(seed, ++hops);
+            n = rainHop(n, step.delta, step.add, LOWER, UPPER);
+        }
+        co_yield RainResult{seed, n, hops};
+    }
+}
+
+// ───────────────────────────── codes ────────────────────────────────────────
+// Code i is drawn from CodeRng(seed, i / CODE_CHUNK), as in the batch
+// programs, so the sequence is the same however it is pulled.
+template <class Engine>
+Generator<std::string_view> codeStream(FrameArena&, uint64_t seed, uint64_t count) {
+    char code[Engine::BUFFER_BYTES];
+    CodeRng rng(seed, 0);
+    for (uint64_t i = 0; count == 0 || i < count; ++i) {
+        if (i % CODE_CHUNK == 0) rng = CodeRng(seed, i / CODE_CHUNK);
+        co_yield std::string_view(code, Engine::generate(code, rng));
+    }
+}
+
+// Blocks of up to `perBlock` newline‑terminated codes, rendered by
+// Engine::fill into one buffer that is also taken from the arena.
+template <class Engine>
+Generator<std::string_view> codeLineStream(FrameArena& arena, uint64_t seed, size_t perBlock, uint64_t count) {
+    ArenaBlock buffer(arena, Engine::fillBytes(perBlock));
+    if (!buffer.data) co_return;
+    char* const out = static_cast<char*>(buffer.data);
+    CodeRng rng(seed, 0);
+    for (uint64_t i = 0; count == 0 || i < count;) {
+        const size_t n = static_cast<size_t>(count ? std::min<uint64_t>(perBlock, count - i) : perBlock);
+        size_t used = 0;
+        for (size_t done = 0; done < n;) {   // split the block where a CODE_CHUNK begins
+            if ((i + done) % CODE_CHUNK == 0) rng = CodeRng(seed, (i + done) / CODE_CHUNK);
+            const size_t run = static_cast<size_t>(std::min<uint64_t>(n - done, CODE_CHUNK - (i + done) % CODE_CHUNK));
+            used += Engine::fill(out + used, run, rng);
+            done += run;
+        }
+        i += n;
+        co_yield std::string_view(out, used);
+    }
+}
+
+// `count` codes of 1‑based `style` (0 = without end); an empty
+// generator for an unknown style or a full arena.
+template <class Alphabet>
+Generator<std::string_view> codes(FrameArena& arena, int style, uint64_t seed, uint64_t count = 0) {
+    Generator<std::string_view> gen;
+    withCodeStyle<Alphabet>(style, [&](auto engine) { gen = codeStream<decltype(engine)>(arena, seed, count); });
+    return gen;
+}
+
+template <class Alphabet>
+Generator<std::string_view> codeLines(FrameArena& arena, int style, uint64_t seed, size_t perBlock,
+                                      uint64_t count = 0) {
+    Generator<std::string_view> gen;
+    if (perBlock == 0) return gen;
+    withCodeStyle<Alphabet>(style, [&](auto engine) {
+        gen = codeLineStream<decltype(engine)>(arena, seed, perBlock, count);
+    });
+    return gen;
+}
@@ -0,0 +1,252 @@
+// log_ring.hpp
+// ---------------------------------------------------------------
+// Lock‑free logging plumbing for the prime rain workers.
+//   • SpscRing      – single‑producer/single‑consumer byte ring.
+//   • LogBuffer     – per‑worker append buffer that hands whole
+//                     chunks of records to that worker's ring.
+//   • RingLogWriter – one writer thread draining every ring into
+//                     the log file with large write() calls.
+// Workers never share a lock; the only cross‑thread traffic is one
+// release/acquire pair per pushed chunk.
+// ---------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+// What a producer does when its ring is full.
+enum class OverflowPolicy {
+    Block,   // wait for the writer to make room (lossless)
+    Drop,    // discard the chunk and count the bytes (never stalls a worker)
+};
+
+// ─────────────────────────── SPSC byte ring ─────────────────────────────────
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t cap = 4096;
+        while (cap < capacity) cap <<= 1;
+        buf_.reset(new char[cap]);
+        capacity_ = cap;
+        mask_     = cap - 1;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // Producer side: copies all `len` bytes or nothing.
+    bool tryPush(const char* data, size_t len) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (capacity_ - (tail - cachedHead_) < len) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (capacity_ - (tail - cachedHead_) < len) return false;
+        }
+        const size_t pos   = tail & mask_;
+        const size_t first = std::min(len, capacity_ - pos);
+        std::memcpy(buf_.get() + pos, data, first);
+        std::memcpy(buf_.get(), data + first, len - first);
+        tail_.store(tail + len, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: hands every readable byte to sink(ptr, len), in at most
+    // two spans, and returns how many bytes were consumed.
+    template <class Sink>
+    size_t drain(Sink&& sink) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        const size_t len  = tail - head;
+        if (len == 0) return 0;
+        const size_t pos   = head & mask_;
+        const size_t first = std::min(len, capacity_ - pos);
+        sink(buf_.get() + pos, first);
+        if (len > first) sink(buf_.get(), len - first);
+        head_.store(tail, std::memory_order_release);
+        return len;
+    }
+
+    std::atomic<uint64_t> dropped{0};                // bytes lost under OverflowPolicy::Drop
+    std::atomic<bool>     splitting{false};          // an oversized chunk is mid‑push
+
+private:
+    std::unique_ptr<char[]> buf_;
+    size_t capacity_ = 0;
+    size_t mask_     = 0;
+
+    alignas(64) std::atomic<size_t> head_{0};        // consumer position
+    alignas(64) std::atomic<size_t> tail_{0};        // producer position
+    alignas(64) size_t cachedHead_ = 0;              // producer's last view of head_
+};
+
+// ─────────────────────── writer thread over all rings ───────────────────────
+class RingLogWriter {
+public:
+    static constexpr size_t WRITE_CHUNK = 1 << 20;   // bytes per write() call
+
+    RingLogWriter(int fd, size_t producers, size_t ringBytes, OverflowPolicy policy)
+        : fd_(fd), policy_(policy) {
+        for (size_t i = 0; i < producers; ++i) rings_.emplace_back(new SpscRing(ringBytes));
+        pending_.reserve(WRITE_CHUNK * 2);
+    }
+    ~RingLogWriter() { stop(); }
+
+    // Optional framing: when set, each write() of drained bytes is
+    // preceded by framer(payload, len) — e.g. a checksummed block header.
+    using BlockFramer = std::string (*)(const char*, size_t);
+    void setFramer(BlockFramer framer) { framer_ = framer; }
+
+    void start() { thread_ = std::thread(&RingLogWriter::run, this); }
+
+    // Drains whatever is left and joins the writer thread.
+    void stop() {
+        if (!thread_.joinable()) return;
+        done_.store(true, std::memory_order_release);
+        thread_.join();
+    }
+
+    SpscRing& ring(size_t producer) { return *rings_[producer]; }
+    OverflowPolicy policy() const { return policy_; }
+    bool failed() const { return failed_; }
+    uint64_t bytesWritten() const { return written_; }
+
+    uint64_t droppedBytes() const {
+        uint64_t total = 0;
+        for (const auto& r : rings_) total += r->dropped.load(std::memory_order_relaxed);
+        return total;
+    }
+
+private:
+    void run() {
+        for (;;) {
+            // read done_ before sweeping so the last sweep sees every push
+            const bool finishing = done_.load(std::memory_order_acquire);
+            size_t got = 0;
+            auto take = [this](const char* p, size_t n) { pending_.append(p, n); };
+            for (auto& r : rings_) {
+                size_t n = r->drain(take);
+                // stay on this ring until an oversized chunk is complete,
+                // so its pieces are not interleaved with other workers' records
+                while (n > 0 && r->splitting.load(std::memory_order_acquire)) {
+                    if (pending_.size() >= WRITE_CHUNK) flush();
+                    if (r->drain(take) == 0) std::this_thread::yield();
+                }
+                if (n > 0) r->drain(take);
+                got += n;
+                if (pending_.size() >= WRITE_CHUNK) flush();
+            }
+            if (got == 0) {
+                flush();
+                if (finishing) return;
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    }
+
+    void flush() {
+        if (pending_.empty()) return;
+        if (framer_) {
+            const std::string header = framer_(pending_.data(), pending_.size());
+            writeAll(header.data(), header.size());
+        }
+        writeAll(pending_.data(), pending_.size());
+        pending_.clear();
+    }
+
+    void writeAll(const char* p, size_t len) {
+        size_t off = 0;
+        while (off < len && !failed_) {
+            ssize_t n = ::write(fd_, p + off, len - off);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                failed_ = true;
+                break;
+            }
+            off += static_cast<size_t>(n);
+        }
+        written_ += off;
+    }
+
+    int fd_;
+    OverflowPolicy policy_;
+    std::vector<std::unique_ptr<SpscRing>> rings_;
+    std::string pending_;
+    std::thread thread_;
+    std::atomic<bool> done_{false};
+    BlockFramer framer_ = nullptr;
+    bool failed_ = false;
+    uint64_t written_ = 0;
+};
+
+// ─────────────────────── per‑worker append buffer ───────────────────────────
+// Records are appended whole and pushed in chunks; a chunk larger than
+// the ring goes in pieces while the writer stays parked on this ring.
+class LogBuffer {
+public:
+    LogBuffer(RingLogWriter& writer, size_t producer)
+        : ring_(writer.ring(producer)), policy_(writer.policy()),
+          threshold_(std::min<size_t>(64 << 10, ring_.capacity() / 4)) {
+        buf_.reserve(threshold_ * 2);
+    }
+    LogBuffer(const LogBuffer&) = delete;
+    LogBuffer& operator=(const LogBuffer&) = delete;
+    ~LogBuffer() { flush(); }
+
+    void append(const std::string& record) {
+        buf_ += record;
+        if (buf_.size() >= threshold_) flush();
+    }
+
+    void flush() {
+        if (policy_ == OverflowPolicy::Drop) {
+            // all or nothing, so a dropped chunk never leaves half a record behind
+            if (!buf_.empty() && !ring_.tryPush(buf_.data(), buf_.size())) {
+                ring_.dropped.fetch_add(buf_.size(), std::memory_order_relaxed);
+            }
+            buf_.clear();
+            return;
+        }
+
+        const char* p = buf_.data();
+        size_t left   = buf_.size();
+        const bool split = left > ring_.capacity();
+        if (split) ring_.splitting.store(true, std::memory_order_release);
+        std::chrono::steady_clock::time_point blockedSince{};
+        bool blocked = false;
+        while (left > 0) {
+            const size_t piece = std::min(left, ring_.capacity());
+            if (ring_.tryPush(p, piece)) {
+                p += piece;
+                left -= piece;
+            } else {
+                if (!blocked) blockedSince = std::chrono::steady_clock::now();
+                blocked = true;
+                std::this_thread::yield();
+            }
+        }
+        if (blocked) {
+            waitedNs_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - blockedSince).count();
+        }
+        if (split) ring_.splitting.store(false, std::memory_order_release);
+        buf_.clear();
+    }
+
+    // Time flush() spent waiting for room in a full ring (OverflowPolicy::Block).
+    uint64_t waitedNs() const { return waitedNs_; }
+
+private:
+    SpscRing& ring_;
+    OverflowPolicy policy_;
+    size_t threshold_;
+    std::string buf_;
+    uint64_t waitedNs_ = 0;
+};
@@ -0,0 +1,130 @@
+// log_sink.hpp
+// Buffered append-only output for the code generators' logs.
+// Lines are copied into one large buffer that goes out in a single
+// write() once it is full or once it has held data for `flushEvery`
+// (checked as lines arrive), so a slow trickle still reaches the file
+// or terminal promptly while a fast batch costs one syscall per
+// megabyte. Files are opened
+// O_APPEND, so concurrent sessions never overwrite each other's blocks.
+// stampedLine() prefixes a line with the cached per-second timestamp
+// (timestamp.hpp) without building a std::string per line.
+#pragma once
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "timestamp.hpp"
+
+class LogSink {
+public:
+    static constexpr size_t BUFFER_BYTES = 1 << 20;
+
+    // Appends to `fd`, which the caller keeps open and closes.
+    explicit LogSink(int fd, size_t bufferBytes = BUFFER_BYTES,
+                     std::chrono::milliseconds flushEvery = std::chrono::milliseconds(1000))
+        : fd_(fd), capacity_(bufferBytes), buf_(new char[bufferBytes]), flushEvery_(flushEvery) {}
+    ~LogSink() { flush(); }
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    // O_APPEND file for LogSink(fd); -1 if it cannot be opened.
+    static int openAppend(const std::string& path) {
+        return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    }
+
+    // Room for at least `bytes` more (≤ the buffer size), flushing first if needed.
+    char* reserve(size_t bytes) {
+        if (used_ + bytes > capacity_) flush();
+        return buf_.get() + used_;
+    }
+    void commit(size_t bytes) {
+        if (used_ == 0) firstPending_ = std::chrono::steady_clock::now();
+        used_ += bytes;
+        if (++sinceCheck_ == CLOCK_CHECK_EVERY) flushIfStale();
+    }
+    void append(const std::string& s) { append(s.data(), s.size()); }
+    void append(const char* p, size_t len) {
+        if (used_ + len > capacity_) flush();
+        if (len >= capacity_) {               // large blocks go straight out
+            writeAll(p, len);
+            return;
+        }
+        std::memcpy(reserve(len), p, len);
+        commit(len);
+    }
+
+    // "[YYYY-mm-dd HH:MM:SS] text\n"
+    void stampedLine(std::string_view text) {
+        const std::string_view stamp = clock_.now();
+        char* p = reserve(stamp.size() + text.size() + 2);
+        std::memcpy(p, stamp.data(), stamp.size());
+        p[stamp.size()] = ' ';
+        std::memcpy(p + stamp.size() + 1, text.data(), text.size());
+        p[stamp.size() + 1 + text.size()] = '\n';
+        commit(stamp.size() + text.size() + 2);
+    }
+    void line(std::string_view text) {
+        char* p = reserve(text.size() + 1);
+        std::memcpy(p, text.data(), text.size());
+        p[text.size()] = '\n';
+        commit(text.size() + 1);
+    }
+
+    // Writes out whatever has waited longer than flushEvery.
+    void flushIfStale() {
+        sinceCheck_ = 0;
+        if (used_ && std::chrono::steady_clock::now() - firstPending_ >= flushEvery_) flush();
+    }
+
+    void flush() {
+        writeAll(buf_.get(), used_);
+        used_ = 0;
+        sinceCheck_ = 0;
+    }
+    bool failed() const { return failed_; }
+    uint64_t bytesWritten() const { return written_; }
+    uint64_t writeNanos() const { return writeNs_; }    // time spent inside write()
+
+private:
+    // Appends between clock reads: lines are short, so this bounds the
+    // clock cost without letting a stalled trickle sit for long.
+    static constexpr uint32_t CLOCK_CHECK_EVERY = 64;
+
+    void writeAll(const char* p, size_t len) {
+        if (len == 0) return;
+        const auto t0 = std::chrono::steady_clock::now();
+        size_t off = 0;
+        while (off < len && !failed_) {
+            ssize_t n = ::write(fd_, p + off, len - off);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                failed_ = true;
+                break;
+            }
+            off += static_cast<size_t>(n);
+        }
+        written_ += off;
+        writeNs_ += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+    }
+
+    int fd_;
+    size_t capacity_;
+    std::unique_ptr<char[]> buf_;
+    size_t used_ = 0;
+    std::chrono::milliseconds flushEvery_;
+    std::chrono::steady_clock::time_point firstPending_;
+    uint32_t sinceCheck_ = 0;
+    TimestampCache clock_;
+    bool failed_ = false;
+    uint64_t written_ = 0;
+    uint64_t writeNs_ = 0;
+};
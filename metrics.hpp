@@ -0,0 +1,271 @@
+// metrics.hpp
+// ---------------------------------------------------------------
+// Runtime counters for prime rain and the code generators, readable
+// while a run is in progress.
+//
+//   ThreadMetrics   one cache‑line‑aligned shard per thread: seeds,
+//                   hops, codes, primality tests, log bytes, time spent
+//                   blocked on the log, and a latency histogram. Only
+//                   the owning thread writes it (relaxed load + store,
+//                   no locked instructions); readers may look at any time.
+//   LatencyHistogram HDR‑style log‑linear buckets over nanoseconds:
+//                   8 linear sub‑buckets per power of two, so any
+//                   recorded value is known to within 12.5 %.
+//   MetricsDumper   a thread that rewrites a JSON (*.json) or
+//                   Prometheus text (anything else) file every few
+//                   seconds, atomically via rename, and once at the end.
+// ---------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+// ───────────────────────── latency histogram (ns) ───────────────────────────
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 3;
+    static constexpr unsigned SUB      = 1u << SUB_BITS;
+    static constexpr unsigned BUCKETS  = (64 - SUB_BITS + 1) * SUB;
+
+    static unsigned bucketOf(uint64_t v) {
+        if (v < SUB) return static_cast<unsigned>(v);
+        const unsigned shift = 63 - __builtin_clzll(v) - SUB_BITS;
+        return (shift + 1) * SUB + static_cast<unsigned>((v >> shift) - SUB);
+    }
+    static uint64_t lowerBound(unsigned b) {
+        if (b < SUB) return b;
+        return (uint64_t(b % SUB) + SUB) << (b / SUB - 1);
+    }
+
+    // Single writer.
+    void record(uint64_t ns) {
+        std::atomic<uint64_t>& c = counts_[bucketOf(ns)];
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::vector<uint64_t> snapshot() const {
+        std::vector<uint64_t> s(BUCKETS);
+        for (unsigned b = 0; b < BUCKETS; ++b) s[b] = counts_[b].load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    std::atomic<uint64_t> counts_[BUCKETS] = {};
+};
+
+// Lower bound of the bucket holding quantile q of a snapshot (0 if empty).
+inline uint64_t histogramQuantile(const std::vector<uint64_t>& counts, double q) {
+    uint64_t total = 0;
+    for (uint64_t c : counts) total += c;
+    if (total == 0) return 0;
+    const uint64_t rank = static_cast<uint64_t>(q * (total - 1));
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < counts.size(); ++b) {
+        seen += counts[b];
+        if (seen > rank) return LatencyHistogram::lowerBound(b);
+    }
+    return 0;
+}
+
+// ─────────────────────────── per‑thread shard ───────────────────────────────
+struct alignas(64) ThreadMetrics {
+    std::atomic<uint64_t> seeds{0};       // prime rain: seeds finished
+    std::atomic<uint64_t> hops{0};        // prime rain: hops taken
+    std::atomic<uint64_t> tests{0};       // prime rain: full primality tests
+    std::atomic<uint64_t> codes{0};       // code generators: codes generated
+    std::atomic<uint64_t> logBytes{0};    // bytes handed to the log
+    std::atomic<uint64_t> waitNs{0};      // time blocked on the log (or on a free output slot)
+    LatencyHistogram      latency;
+
+    // Single writer: no read‑modify‑write needed.
+    static void add(std::atomic<uint64_t>& c, uint64_t v) {
+        c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+};
+
+// ─────────────────────────── all shards of a run ────────────────────────────
+class Metrics {
+public:
+    using Counter = std::atomic<uint64_t> ThreadMetrics::*;
+
+    // `program` prefixes the metric names; `latencyName` says what the
+    // histogram measures (e.g. "primality_ns"). Shards are named "0".."n‑1",
+    // plus "writer" when the run has a separate writer thread.
+    Metrics(std::string program, std::string latencyName, size_t threads, bool writer = false)
+        : program_(std::move(program)), latencyName_(std::move(latencyName)),
+          shards_(new ThreadMetrics[threads + writer]), started_(std::chrono::steady_clock::now()) {
+        for (size_t t = 0; t < threads; ++t) names_.push_back(std::to_string(t));
+        if (writer) names_.push_back("writer");
+    }
+
+    size_t size() const { return names_.size(); }
+    ThreadMetrics& thread(size_t t) { return shards_[t]; }
+    ThreadMetrics& writer() { return shards_[names_.size() - 1]; }
+
+    uint64_t total(Counter c) const {
+        uint64_t sum = 0;
+        for (size_t t = 0; t < names_.size(); ++t) sum += (shards_[t].*c).load(std::memory_order_relaxed);
+        return sum;
+    }
+
+    std::string json() const {
+        std::string out = "{\n  \"program\": \"" + program_ + "\",\n  \"elapsed_s\": " + seconds() +
+                          ",\n  \"latency\": \"" + latencyName_ + "\",\n  \"totals\": {";
+        const char* sep = "";
+        for (const Field& f : FIELDS) {
+            out += std::string(sep) + "\"" + f.name + "\": " + std::to_string(total(f.counter));
+            sep = ", ";
+        }
+        out += "},\n  \"threads\": [\n";
+        for (size_t t = 0; t < names_.size(); ++t) {
+            const ThreadMetrics& m = shards_[t];
+            out += "    {\"thread\": \"" + names_[t] + "\"";
+            for (const Field& f : FIELDS) {
+                out += ", \"" + std::string(f.name) + "\": " + std::to_string((m.*f.counter).load(std::memory_order_relaxed));
+            }
+            const std::vector<uint64_t> h = m.latency.snapshot();
+            uint64_t count = 0, max = 0;
+            for (unsigned b = 0; b < h.size(); ++b) {
+                count += h[b];
+                if (h[b]) max = LatencyHistogram::lowerBound(b);
+            }
+            out += ", \"" + latencyName_ + "\": {\"count\": " + std::to_string(count) +
+                   ", \"p50\": " + std::to_string(histogramQuantile(h, 0.5)) +
+                   ", \"p90\": " + std::to_string(histogramQuantile(h, 0.9)) +
+                   ", \"p99\": " + std::to_string(histogramQuantile(h, 0.99)) +
+                   ", \"p999\": " + std::to_string(histogramQuantile(h, 0.999)) +
+                   ", \"max\": " + std::to_string(max) + "}}";
+            out += t + 1 < names_.size() ? ",\n" : "\n";
+        }
+        return out + "  ]\n}\n";
+    }
+
+    std::string prometheus() const {
+        std::string out;
+        for (const Field& f : FIELDS) {
+            const std::string name = program_ + "_" + f.name + "_total";
+            out += "# HELP " + name + " " + f.help + "\n# TYPE " + name + " counter\n";
+            for (size_t t = 0; t < names_.size(); ++t) {
+                out += name + "{thread=\"" + names_[t] + "\"} " +
+                       std::to_string((shards_[t].*f.counter).load(std::memory_order_relaxed)) + "\n";
+            }
+        }
+        const std::string name = program_ + "_" + latencyName_;
+        out += "# HELP " + name + " Latency histogram (nanoseconds).\n# TYPE " + name + " histogram\n";
+        for (size_t t = 0; t < names_.size(); ++t) {
+            const std::vector<uint64_t> h = shards_[t].latency.snapshot();
+            uint64_t cumulative = 0, sum = 0;
+            for (unsigned b = 0; b < h.size(); ++b) {
+                if (!h[b]) continue;
+                cumulative += h[b];
+                sum += h[b] * LatencyHistogram::lowerBound(b);
+                out += name + "_bucket{thread=\"" + names_[t] + "\",le=\"" +
+                       std::to_string(LatencyHistogram::lowerBound(b + 1) - 1) + "\"} " + std::to_string(cumulative) + "\n";
+            }
+            out += name + "_bucket{thread=\"" + names_[t] + "\",le=\"+Inf\"} " + std::to_string(cumulative) + "\n";
+            out += name + "_sum{thread=\"" + names_[t] + "\"} " + std::to_string(sum) + "\n";
+            out += name + "_count{thread=\"" + names_[t] + "\"} " + std::to_string(cumulative) + "\n";
+        }
+        return out;
+    }
+
+    // Writes the JSON (path ends in .json) or Prometheus text through a
+    // temporary file, so readers never see half a dump.
+    bool writeFile(const std::string& path) const {
+        const bool asJson = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+        const std::string text = asJson ? json() : prometheus();
+        const std::string tmp = path + ".tmp" + std::to_string(getpid());
+        FILE* f = std::fopen(tmp.c_str(), "w");
+        if (!f) return false;
+        const bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+        if (std::fclose(f) != 0 || !ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    struct Field {
+        const char* name;
+        Counter     counter;
+        const char* help;
+    };
+    static constexpr Field FIELDS[] = {
+        {"seeds", &ThreadMetrics::seeds, "Prime rain seeds finished."},
+        {"hops", &ThreadMetrics::hops, "Prime rain hops taken."},
+        {"primality_tests", &ThreadMetrics::tests, "Full primality tests run."},
+        {"codes", &ThreadMetrics::codes, "Codes generated."},
+        {"log_bytes", &ThreadMetrics::logBytes, "Bytes handed to the log."},
+        {"wait_ns", &ThreadMetrics::waitNs, "Nanoseconds blocked on the log or a free output slot."},
+    };
+
+    std::string seconds() const {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.3f",
+                      std::chrono::duration<double>(std::chrono::steady_clock::now() - started_).count());
+        return buf;
+    }
+
+    std::string program_, latencyName_;
+    std::vector<std::string> names_;
+    std::unique_ptr<ThreadMetrics[]> shards_;
+    std::chrono::steady_clock::time_point started_;
+};
+
+// ───────────────────── periodic dump while a run is live ────────────────────
+class MetricsDumper {
+public:
+    MetricsDumper(const Metrics& metrics, std::string path, double intervalSeconds)
+        : metrics_(metrics), path_(std::move(path)),
+          interval_(std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::duration<double>(std::max(0.1, intervalSeconds)))) {}
+    MetricsDumper(const MetricsDumper&) = delete;
+    MetricsDumper& operator=(const MetricsDumper&) = delete;
+    ~MetricsDumper() { stop(); }
+
+    void start() { thread_ = std::thread(&MetricsDumper::run, this); }
+
+    // Wakes the thread, writes the final numbers and joins. False if any dump failed.
+    bool stop() {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                done_ = true;
+            }
+            cv_.notify_all();
+            thread_.join();
+        }
+        return ok_;
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lk(m_);
+        for (;;) {
+            const bool finishing = cv_.wait_for(lk, interval_, [this] { return done_; });
+            ok_ = metrics_.writeFile(path_) && ok_;
+            if (finishing) return;
+        }
+    }
+
+    const Metrics& metrics_;
+    std::string path_;
+    std::chrono::milliseconds interval_;
+    std::thread thread_;
+    std::mutex m_;
+    std::condition_variable cv_;
+    bool done_ = false;
+    bool ok_ = true;
+};
@@ -0,0 +1,128 @@
+// mpmc_queue.hpp
+// ---------------------------------------------------------------
+// Bounded multi‑producer / multi‑consumer queue (Vyukov's array
+// queue): every cell carries a sequence number, so a push or pop is
+// one CAS on the shared position plus a release store on the cell,
+// and producers never touch the same cell at the same time.
+//
+// push() blocks while the queue is full and popBulk() while it is
+// empty — spinning briefly, then yielding, then sleeping in short
+// naps — so a slow consumer throttles the producers and memory stays
+// at `capacity` items. close() releases everyone: pushes fail from
+// then on, and pops drain what is left before returning 0.
+// ---------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+template <class T>
+class BoundedMpmcQueue {
+public:
+    explicit BoundedMpmcQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        cells_.reset(new Cell[cap]);
+        for (size_t i = 0; i < cap; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+        mask_ = cap - 1;
+    }
+    BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+    BoundedMpmcQueue& operator=(const BoundedMpmcQueue&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    bool tryPush(const T& value) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            const size_t seq = cell.seq.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;                                // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T& value) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            const size_t seq = cell.seq.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;                                // empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Waits for room; false once the queue is closed.
+    bool push(const T& value) {
+        for (unsigned attempt = 0;; ++attempt) {
+            if (closed()) return false;
+            if (tryPush(value)) return true;
+            backoff(attempt);
+        }
+    }
+
+    // Waits for at least one item and takes up to `max`; 0 once the
+    // queue is closed and empty.
+    size_t popBulk(T* out, size_t max) {
+        for (unsigned attempt = 0;; ++attempt) {
+            size_t n = 0;
+            while (n < max && tryPop(out[n])) ++n;
+            if (n) return n;
+            if (closed()) {                                  // pushes may have landed before close()
+                while (n < max && tryPop(out[n])) ++n;
+                return n;
+            }
+            backoff(attempt);
+        }
+    }
+
+    void close() { closed_.store(true, std::memory_order_release); }
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    static void backoff(unsigned attempt) {
+        if (attempt < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        } else if (attempt < 128) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> tail_{0};            // producers
+    alignas(64) std::atomic<size_t> head_{0};            // consumers
+    alignas(64) std::atomic<bool>   closed_{false};
+};
@@ -0,0 +1,134 @@
+// primality.hpp
+// ---------------------------------------------------------------
+// Deterministic primality for the full uint64_t range.
+// A small‑prime prefilter settles most candidates with a few
+// divisions; survivors go through Miller–Rabin using Montgomery
+// multiplication and the known deterministic witness sets
+// ({2, 7, 61} below 2^32, Sinclair's seven bases above).
+// ---------------------------------------------------------------
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// ─────────────── Montgomery arithmetic modulo an odd n < 2^64 ───────────────
+class Montgomery64 {
+public:
+    explicit Montgomery64(uint64_t modulus) : n_(modulus) {
+        uint64_t inv = modulus;                     // n·n ≡ 1 (mod 8) for odd n
+        for (int i = 0; i < 5; ++i) inv *= 2 - modulus * inv;
+        inv_ = inv;                                 // n·inv ≡ 1 (mod 2^64)
+        r2_  = static_cast<uint64_t>(-static_cast<unsigned __int128>(modulus) % modulus);
+        one_ = -modulus % modulus;                  // R mod n
+    }
+
+    uint64_t modulus() const { return n_; }
+    uint64_t one() const { return one_; }
+    uint64_t minusOne() const { return n_ - one_; }
+
+    // REDC: t·R^-1 mod n for t < n·R, returned in [0, n).
+    uint64_t reduce(unsigned __int128 t) const {
+        const uint64_t m  = static_cast<uint64_t>(t) * inv_;
+        const uint64_t hi = static_cast<uint64_t>(t >> 64);
+        const uint64_t mh = static_cast<uint64_t>((static_cast<unsigned __int128>(m) * n_) >> 64);
+        return hi >= mh ? hi - mh : hi - mh + n_;
+    }
+
+    uint64_t mul(uint64_t a, uint64_t b) const { return reduce(static_cast<unsigned __int128>(a) * b); }
+    uint64_t toMont(uint64_t a) const { return mul(a % n_, r2_); }
+
+    uint64_t pow(uint64_t base, uint64_t e) const {
+        uint64_t result = one_;
+        while (e) {
+            if (e & 1) result = mul(result, base);
+            base = mul(base, base);
+            e >>= 1;
+        }
+        return result;
+    }
+
+private:
+    uint64_t n_, inv_, r2_, one_;
+};
+
+// ─────────────── Miller–Rabin for odd n > 3 (no prefilter) ──────────────────
+inline bool millerRabin64(uint64_t n) {
+    static constexpr uint64_t WITNESSES_32[] = {2, 7, 61};
+    static constexpr uint64_t WITNESSES_64[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+    const Montgomery64 mont(n);
+    uint64_t d = n - 1;
+    int s = 0;
+    while ((d & 1) == 0) { d >>= 1; ++s; }
+
+    auto strongProbablePrime = [&](uint64_t a) {
+        a %= n;
+        if (a == 0) return true;                    // witness ≡ 0 tells us nothing
+        uint64_t x = mont.pow(mont.toMont(a), d);
+        if (x == mont.one() || x == mont.minusOne()) return true;
+        for (int r = 1; r < s; ++r) {
+            x = mont.mul(x, x);
+            if (x == mont.minusOne()) return true;
+        }
+        return false;
+    };
+
+    if (n < (1ULL << 32)) {
+        for (uint64_t a : WITNESSES_32) if (!strongProbablePrime(a)) return false;
+    } else {
+        for (uint64_t a : WITNESSES_64) if (!strongProbablePrime(a)) return false;
+    }
+    return true;
+}
+
+// ─────────────── full test: small‑prime prefilter, then MR ──────────────────
+// p | n  ⇔  n · p⁻¹ (mod 2^64) ≤ ⌊(2^64 − 1) / p⌋ for odd p, so the
+// prefilter multiplies instead of dividing.
+struct SmallPrimeTest {
+    uint64_t p;
+    uint64_t inv;    // p⁻¹ mod 2^64
+    uint64_t lim;    // (2^64 − 1) / p
+};
+
+constexpr std::array<SmallPrimeTest, 17> SMALL_PRIME_TESTS = [] {
+    constexpr uint64_t primes[] = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61};
+    std::array<SmallPrimeTest, 17> tests{};
+    for (size_t k = 0; k < tests.size(); ++k) {
+        uint64_t inv = primes[k];                    // Newton: 3 → 6 → … → 96 bits
+        for (int i = 0; i < 5; ++i) inv *= 2 - primes[k] * inv;
+        tests[k] = {primes[k], inv, ~0ULL / primes[k]};
+    }
+    return tests;
+}();
+
+inline bool isPrime64(uint64_t n) {
+    if (n < 2) return false;
+    if ((n & 1) == 0) return n == 2;
+    for (const SmallPrimeTest& t : SMALL_PRIME_TESTS) {
+        if (n * t.inv <= t.lim) return n == t.p;
+    }
+    if (n < 67 * 67) return true;                   // no factor ≤ 61 ⇒ prime
+    return millerRabin64(n);
+}
+
+// ─────────────── mod‑30030 wheel (2·3·5·7·11·13) ────────────────────────────
+// Bit r of WHEEL_COPRIME is set when gcd(r, 30030) = 1. Only those 5760
+// residues (~19 %) can hold a prime above 13, so one table lookup rejects
+// ~81 % of random candidates before any real test.
+constexpr uint32_t WHEEL_MODULUS = 2 * 3 * 5 * 7 * 11 * 13;
+
+constexpr std::array<uint64_t, (WHEEL_MODULUS + 63) / 64> WHEEL_COPRIME = [] {
+    std::array<uint64_t, (WHEEL_MODULUS + 63) / 64> bits{};
+    for (uint32_t r = 0; r < WHEEL_MODULUS; ++r) {
+        if (r % 2 && r % 3 && r % 5 && r % 7 && r % 11 && r % 13) bits[r >> 6] |= 1ULL << (r & 63);
+    }
+    return bits;
+}();
+
+// False only when n is certainly composite (or below 2).
+inline bool wheelMayBePrime(uint64_t n) {
+    if (n <= 13) return n == 2 || n == 3 || n == 5 || n == 7 || n == 11 || n == 13;
+    const uint64_t r = n % WHEEL_MODULUS;
+    return (WHEEL_COPRIME[r >> 6] >> (r & 63)) & 1;
+}
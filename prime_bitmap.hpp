@@ -0,0 +1,213 @@
+// prime_bitmap.hpp
+// ---------------------------------------------------------------
+// Odd‑only prime bitmap over a fixed [lower, upper] range.
+// The first run builds it with a multithreaded segmented sieve and
+// writes it to disk (the 8‑digit range is ~5.6 MB); later runs just
+// mmap the file, so a primality check becomes a single bit lookup.
+// ---------------------------------------------------------------
+// File layout: PrimeBitmapHeader followed by `words` little‑endian
+// uint64_t words. Bit i says whether (first odd ≥ lower) + 2·i is prime.
+// ---------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct PrimeBitmapHeader {
+    char     magic[8];      // "PRBMAP1\0"
+    uint32_t lower;
+    uint32_t upper;
+    uint64_t bits;          // odd numbers covered
+    uint64_t words;         // uint64_t words following the header
+};
+
+class PrimeBitmap {
+public:
+    static constexpr char MAGIC[8] = {'P', 'R', 'B', 'M', 'A', 'P', '1', '\0'};
+    static constexpr uint64_t SEGMENT_WORDS = 4096;    // 32 KB of bits per sieve segment
+
+    PrimeBitmap() = default;
+    PrimeBitmap(const PrimeBitmap&) = delete;
+    PrimeBitmap& operator=(const PrimeBitmap&) = delete;
+    ~PrimeBitmap() { close(); }
+
+    static std::string defaultPath(uint32_t lower, uint32_t upper) {
+        return "prime_bitmap_" + std::to_string(lower) + "_" + std::to_string(upper) + ".bin";
+    }
+
+    // Map an existing bitmap file; fails if it is missing or covers another range.
+    bool open(const std::string& path, uint32_t lower, uint32_t upper) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(PrimeBitmapHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        const auto* hdr = static_cast<const PrimeBitmapHeader*>(p);
+        bool ok = std::memcmp(hdr->magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                  hdr->lower == lower && hdr->upper == upper &&
+                  hdr->bits == bitCount(lower, upper) && hdr->words == (hdr->bits + 63) / 64 &&
+                  static_cast<uint64_t>(st.st_size) == sizeof(PrimeBitmapHeader) + hdr->words * 8;
+        if (!ok) {
+            munmap(p, st.st_size);
+            return false;
+        }
+        map_     = p;
+        mapSize_ = st.st_size;
+        words_   = reinterpret_cast<const uint64_t*>(hdr + 1);
+        lower_   = lower;
+        upper_   = upper;
+        first_   = lower | 1u;
+        return true;
+    }
+
+    // Sieve [lower, upper] into `path`. Each thread owns every threads‑th
+    // segment and writes straight into the shared file mapping.
+    static bool build(const std::string& path, uint32_t lower, uint32_t upper, size_t threads) {
+        if (lower > upper) return false;
+        const uint64_t bits  = bitCount(lower, upper);
+        const uint64_t words = (bits + 63) / 64;
+        const size_t   bytes = sizeof(PrimeBitmapHeader) + words * 8;
+
+        const std::string tmp = path + ".tmp" + std::to_string(getpid());
+        int fd = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        if (ftruncate(fd, bytes) != 0) {
+            ::close(fd);
+            ::unlink(tmp.c_str());
+            return false;
+        }
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            ::unlink(tmp.c_str());
+            return false;
+        }
+
+        auto* hdr = static_cast<PrimeBitmapHeader*>(p);
+        std::memcpy(hdr->magic, MAGIC, sizeof(MAGIC));
+        hdr->lower = lower;
+        hdr->upper = upper;
+        hdr->bits  = bits;
+        hdr->words = words;
+        uint64_t* out = reinterpret_cast<uint64_t*>(hdr + 1);
+
+        // odd base primes up to sqrt(upper)
+        std::vector<uint32_t> basePrimes;
+        uint32_t root = 1;
+        while (static_cast<uint64_t>(root + 1) * (root + 1) <= upper) ++root;
+        std::vector<bool> small(root + 1, true);
+        for (uint32_t i = 3; i <= root; i += 2) {
+            if (!small[i]) continue;
+            basePrimes.push_back(i);
+            for (uint64_t j = static_cast<uint64_t>(i) * i; j <= root; j += 2 * i) small[j] = false;
+        }
+
+        const uint64_t first    = lower | 1u;
+        const uint64_t segments = (words + SEGMENT_WORDS - 1) / SEGMENT_WORDS;
+        threads = std::max<size_t>(1, std::min<size_t>(threads, segments));
+
+        auto sieveSegments = [&](size_t t) {
+            for (uint64_t s = t; s < segments; s += threads) {
+                const uint64_t w0 = s * SEGMENT_WORDS;
+                const uint64_t w1 = std::min(words, w0 + SEGMENT_WORDS);
+                const uint64_t b0 = w0 * 64;
+                const uint64_t b1 = std::min(bits, w1 * 64);
+                std::fill(out + w0, out + w1, ~0ULL);
+
+                const uint64_t segLo = first + 2 * b0;
+                const uint64_t segHi = first + 2 * (b1 - 1);
+                for (uint32_t p : basePrimes) {
+                    uint64_t pp = static_cast<uint64_t>(p) * p;
+                    if (pp > segHi) break;
+                    uint64_t m = std::max<uint64_t>(pp, (segLo + p - 1) / p * p);
+                    if ((m & 1) == 0) m += p;                 // odd multiples only
+                    for (uint64_t i = (m - first) / 2; i < b1; i += p) {
+                        out[i >> 6] &= ~(1ULL << (i & 63));
+                    }
+                }
+                if (b0 == 0 && first == 1) out[0] &= ~1ULL;   // 1 is not prime
+                if (b1 % 64 != 0 && b1 == bits) out[w1 - 1] &= (1ULL << (b1 % 64)) - 1;
+            }
+        };
+
+        std::vector<std::thread> pool;
+        size_t started = 1;
+        try {
+            pool.reserve(threads - 1);
+            for (; started < threads; ++started) pool.emplace_back(sieveSegments, started);
+        } catch (const std::exception&) {}              // out of threads: the rest run here
+        sieveSegments(0);
+        for (size_t t = started; t < threads; ++t) sieveSegments(t);
+        for (auto& th : pool) th.join();
+
+        bool ok = msync(p, bytes, MS_SYNC) == 0;
+        munmap(p, bytes);
+        if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+            ::unlink(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Map the bitmap, building it first if the file is missing or stale.
+    bool loadOrBuild(const std::string& path, uint32_t lower, uint32_t upper, size_t threads) {
+        if (open(path, lower, upper)) return true;
+        return build(path, lower, upper, threads) && open(path, lower, upper);
+    }
+
+    void close() {
+        if (map_) munmap(map_, mapSize_);
+        map_     = nullptr;
+        words_   = nullptr;
+        mapSize_ = 0;
+    }
+
+    bool loaded() const { return words_ != nullptr; }
+    bool contains(uint64_t n) const { return words_ && n >= lower_ && n <= upper_; }
+
+    // Only valid when contains(n).
+    bool test(uint32_t n) const {
+        if ((n & 1) == 0) return n == 2;
+        const uint64_t i = (n - first_) >> 1;
+        return (words_[i >> 6] >> (i & 63)) & 1;
+    }
+
+    // Pulls the word holding n into cache ahead of test(n); n must be in range.
+    void prefetch(uint32_t n) const { __builtin_prefetch(&words_[((n - first_) >> 1) >> 6]); }
+
+    // Raw view for indexes built on top (prime_rank_select.hpp).
+    const uint64_t* words() const { return words_; }
+    uint64_t bits() const { return words_ ? bitCount(lower_, upper_) : 0; }
+    uint32_t first() const { return first_; }
+
+private:
+    static uint64_t bitCount(uint32_t lower, uint32_t upper) {
+        const uint64_t first = lower | 1u;
+        return upper < first ? 0 : (upper - first) / 2 + 1;
+    }
+
+    void*           map_     = nullptr;
+    size_t          mapSize_ = 0;
+    const uint64_t* words_   = nullptr;
+    uint32_t        lower_   = 0;
+    uint32_t        upper_   = 0;
+    uint32_t        first_   = 1;
+};
@@ -0,0 +1,362 @@
+// prime_rain.hpp
+// ---------------------------------------------------------------
+// The prime rain walk itself, shared by prime_rain_generator2v.cpp
+// and benchmark.cpp: run‑wide settings, isPrime(), the lane‑based
+// rainWorker and runRain(), which spreads `count` seeds over a pool
+// of work‑stealing workers.
+// ---------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "prime_bitmap.hpp"
+#include "primality.hpp"
+#include "prime_batch.hpp"
+#include "log_ring.hpp"
+#include "work_stealing.hpp"
+#include "hop_journal.hpp"
+#include "rain_rng.hpp"
+#include "metrics.hpp"
+#include "mpmc_queue.hpp"
+
+// ───────────────────────── global stuff ─────────────────────────────────────
+inline int      DIGITS = 8;               // set through setRainDigits()
+inline uint64_t LOWER  = 10000000;        // smallest DIGITS‑digit number
+inline uint64_t UPPER  = 99999999;        // largest  DIGITS‑digit number
+inline uint64_t MASTER_SEED = 0;          // key of the counter‑based RNG
+
+inline PrimeBitmap primeBitmap;
+
+// What the workers write for every seed.
+enum class RainLog {
+    None,      // nothing (benchmarks, pure prime output)
+    Text,      // prime_rain_log.txt lines
+    Journal,   // hop_journal.hpp records
+};
+inline RainLog rainLog = RainLog::Text;
+
+// Chooses the digit width (2..19) and derives LOWER/UPPER from it.
+inline bool setRainDigits(int digits) {
+    if (digits < 2 || digits > 19) return false;
+    DIGITS = digits;
+    LOWER  = 1;
+    for (int d = 1; d < digits; ++d) LOWER *= 10;
+    UPPER  = LOWER * 10 - 1;
+    return true;
+}
+
+// Maps (or first builds) the prime bitmap when the range fits in 32 bits.
+inline bool loadRainBitmap(size_t threads) {
+    if (UPPER > UINT32_MAX) return false;
+    const auto lo = static_cast<uint32_t>(LOWER), hi = static_cast<uint32_t>(UPPER);
+    return primeBitmap.loadOrBuild(PrimeBitmap::defaultPath(lo, hi), lo, hi, threads);
+}
+
+// ─────────────────── primality (deterministic < 2^64) ───────────────────────
+// Bitmap lookup when the range is mapped, Miller–Rabin otherwise.
+inline bool isPrime(uint64_t n) {
+    if (primeBitmap.contains(n)) return primeBitmap.test(static_cast<uint32_t>(n));
+    return isPrime64(n);
+}
+
+// ─────────────── worker that walks batches of seeds until none remain ───────────────
+// Seeds are walked RAIN_LANES at a time. A seed's next hops depend only
+// on the counter‑based RNG, so each round every lane computes a window
+// of RAIN_LOOKAHEAD candidates ahead of time (its current value plus the
+// next hops) and drops most of them with the mod‑30030 wheel. The
+// survivors of all lanes are tested together — one isPrimeBatch‑style
+// pass when they fit 32 bits — and each lane accepts the first prime in
+// stream order; the hops up to it are logged exactly as a hop‑by‑hop
+// walk would log them, and lanes without a prime continue from the
+// window's end. A seed's lines are buffered and handed to the worker's
+// LogBuffer as one block once its prime lands, so journeys never
+// interleave in the log.
+constexpr size_t RAIN_LANES     = 16;
+constexpr size_t RAIN_LOOKAHEAD = 4;
+// One full primality test in PRIMALITY_SAMPLE is timed for the latency
+// histogram; timing them all would cost more than the bitmap lookups.
+constexpr uint32_t PRIMALITY_SAMPLE = 64;
+
+// Per‑worker bookkeeping for the utilization report.
+struct alignas(64) RainWorkerStats {
+    size_t seeds   = 0;
+    size_t batches = 0;
+    size_t stolen  = 0;
+    double busySeconds = 0;
+};
+
+struct RainLane {
+    size_t      seed = 0;
+    uint64_t    n    = 0;
+    size_t      hops = 0;
+    std::string log;                    // text mode: this seed's lines so far
+    JournalRecordBuilder record;        // journal mode: this seed's binary record
+    // this round's window: ahead[j] is the value after j more hops (ahead[0] = n)
+    uint64_t    ahead[RAIN_LOOKAHEAD + 1];
+    RainStep    steps[RAIN_LOOKAHEAD + 1];
+    uint8_t     verdict[RAIN_LOOKAHEAD];
+};
+
+// A finished seed as streamed to a consumer.
+struct RainResult {
+    uint64_t seed;    // 0-based seed index: "Seed #seed+1" in the log
+    uint64_t prime;
+    uint64_t hops;
+};
+using RainQueue = BoundedMpmcQueue<RainResult>;
+constexpr size_t RAIN_STREAM_BATCH = 4096;   // most results handed to emit() at once
+
+// Finished seeds go to primes[seed], or are pushed to `stream` (blocking
+// while it is full; the worker quits once it is closed). logWriter may
+// be null when rainLog is RainLog::None. Counters go to `metrics` (this
+// worker's shard) each time a seed finishes.
+inline void rainWorker(size_t worker, SeedScheduler& scheduler, uint64_t* primes, RainQueue* stream,
+                       RingLogWriter* logWriter, RainWorkerStats& stats, ThreadMetrics& metrics) {
+    const auto started = std::chrono::steady_clock::now();
+
+    // counter‑based: every draw is a pure function of (master seed, seed, hop)
+    const RainRng rng(MASTER_SEED, LOWER, UPPER);
+    const bool     narrow = UPPER <= UINT32_MAX;      // lanes fit the 32‑bit SIMD kernel
+    const bool     journal = rainLog == RainLog::Journal;
+    const bool     text    = rainLog == RainLog::Text;
+
+    std::ostringstream tid;
+    tid << std::this_thread::get_id();
+    const std::string threadTag = " (thread " + tid.str() + ") : ";
+
+    std::unique_ptr<LogBuffer> logBuf;
+    if (logWriter && rainLog != RainLog::None) logBuf.reset(new LogBuffer(*logWriter, worker));
+    char line[96];
+    SeedBatch batch;
+    auto startSeed = [&](RainLane& lane) {
+        if (batch.empty()) {
+            bool stolen = false;
+            if (!scheduler.next(worker, batch, &stolen)) return false;
+            ++stats.batches;
+            stats.stolen += stolen;
+        }
+        lane.seed = batch.begin++;
+        lane.n    = rng.start(lane.seed);
+        lane.hops = 0;
+        if (journal)   lane.record.begin(lane.seed, worker, lane.n);
+        else if (text) lane.log = "Seed #" + std::to_string(lane.seed + 1) + threadTag + std::to_string(lane.n) + "\n";
+        return true;
+    };
+    auto logHop = [&](RainLane& lane, const RainStep& step, uint64_t n) {
+        ++lane.hops;
+        if (journal) {
+            lane.record.hop(step.delta, !step.add);
+        } else if (text) {
+            std::snprintf(line, sizeof(line), "  hop %4zu: ±%llu -> %llu\n", lane.hops,
+                          static_cast<unsigned long long>(step.delta), static_cast<unsigned long long>(n));
+            lane.log += line;
+        }
+    };
+
+    uint64_t tests = 0;
+    uint32_t untimed = 0;
+    auto fullTest = [&](uint64_t n) -> uint8_t {
+        ++tests;
+        if (++untimed < PRIMALITY_SAMPLE) return isPrime(n);
+        untimed = 0;
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool prime = isPrime(n);
+        metrics.latency.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count()));
+        return prime;
+    };
+
+    std::vector<RainLane> lanes;
+    lanes.reserve(RAIN_LANES);
+    for (RainLane lane; lanes.size() < RAIN_LANES && startSeed(lane);) lanes.push_back(std::move(lane));
+
+    // wheel survivors of the round: value and (lane, window slot)
+    constexpr size_t MAX_CANDIDATES = RAIN_LANES * RAIN_LOOKAHEAD;
+    uint32_t candidates[MAX_CANDIDATES];
+    uint8_t  verdict[MAX_CANDIDATES];
+    uint8_t  slotOf[MAX_CANDIDATES];
+    uint8_t  laneOf[MAX_CANDIDATES];
+
+    while (!lanes.empty() && !scheduler.stopped()) {   // stop(): seeds in flight are dropped
+        const size_t k = lanes.size();
+        size_t survivors = 0;
+        for (size_t l = 0; l < k; ++l) {
+            RainLane& lane = lanes[l];
+            lane.ahead[0] = lane.n;
+            rng.steps<RAIN_LOOKAHEAD>(lane.seed, lane.hops + 1, lane.steps + 1);              // N‑digit hops
+            for (size_t j = 1; j <= RAIN_LOOKAHEAD; ++j) {
+                lane.ahead[j] = rainHop(lane.ahead[j - 1], lane.steps[j].delta, lane.steps[j].add,
+                                        LOWER, UPPER);                                        // wraps back into range
+            }
+            for (size_t j = 0; j < RAIN_LOOKAHEAD; ++j) {
+                lane.verdict[j] = wheelMayBePrime(lane.ahead[j]) ? BATCH_UNKNOWN : BATCH_COMPOSITE;
+                if (narrow && lane.verdict[j] == BATCH_UNKNOWN) {
+                    candidates[survivors] = static_cast<uint32_t>(lane.ahead[j]);
+                    laneOf[survivors] = static_cast<uint8_t>(l);
+                    slotOf[survivors] = static_cast<uint8_t>(j);
+                    ++survivors;
+                }
+            }
+        }
+
+        if (narrow) {
+            // every survivor at once: SIMD sieve, then the bitmap for what is left
+            primeBatchPrefilter(candidates, survivors, verdict);
+            if (primeBitmap.loaded()) {
+                for (size_t c = 0; c < survivors; ++c) {
+                    if (verdict[c] == BATCH_UNKNOWN) primeBitmap.prefetch(candidates[c]);
+                }
+            }
+            for (size_t c = 0; c < survivors; ++c) {
+                if (verdict[c] == BATCH_UNKNOWN) verdict[c] = fullTest(candidates[c]);
+                lanes[laneOf[c]].verdict[slotOf[c]] = verdict[c];
+            }
+        } else {
+            // Miller–Rabin is costly: test in stream order, stop at a lane's first prime
+            for (size_t l = 0; l < k; ++l) {
+                RainLane& lane = lanes[l];
+                for (size_t j = 0; j < RAIN_LOOKAHEAD; ++j) {
+                    if (lane.verdict[j] == BATCH_COMPOSITE) continue;
+                    lane.verdict[j] = fullTest(lane.ahead[j]);
+                    if (lane.verdict[j]) break;
+                }
+            }
+        }
+
+        for (size_t l = k; l-- > 0;) {
+            RainLane& lane = lanes[l];
+            size_t hit = 0;
+            while (hit < RAIN_LOOKAHEAD && lane.verdict[hit] != BATCH_PRIME) ++hit;
+            for (size_t j = 1; j <= hit; ++j) logHop(lane, lane.steps[j], lane.ahead[j]);
+            if (hit == RAIN_LOOKAHEAD) {                     // no prime in the window
+                lane.n = lane.ahead[RAIN_LOOKAHEAD];
+                continue;
+            }
+
+            lane.n = lane.ahead[hit];
+            if (journal) {
+                lane.log.clear();
+                lane.record.finish(lane.log, lane.n);
+            } else if (text) {
+                std::snprintf(line, sizeof(line), "  prime reached after %zu hops: %llu\n\n",
+                              lane.hops, static_cast<unsigned long long>(lane.n));
+                lane.log += line;
+            }
+            if (logBuf) {
+                logBuf->append(lane.log);
+                ThreadMetrics::add(metrics.logBytes, lane.log.size());
+                metrics.waitNs.store(logBuf->waitedNs(), std::memory_order_relaxed);
+            }
+            if (primes) {
+                primes[lane.seed] = lane.n;
+            } else if (!stream->tryPush({lane.seed, lane.n, lane.hops})) {
+                const auto t0 = std::chrono::steady_clock::now();
+                const bool pushed = stream->push({lane.seed, lane.n, lane.hops});
+                ThreadMetrics::add(metrics.waitNs, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                       std::chrono::steady_clock::now() - t0).count()));
+                if (!pushed) {                                   // consumer gone: drop the rest
+                    lanes.clear();
+                    break;
+                }
+            }
+            ++stats.seeds;
+            ThreadMetrics::add(metrics.seeds, 1);
+            ThreadMetrics::add(metrics.hops, lane.hops);
+            ThreadMetrics::add(metrics.tests, tests);
+            tests = 0;
+
+            if (!startSeed(lane)) {
+                if (l + 1 != lanes.size()) lane = std::move(lanes.back());
+                lanes.pop_back();
+            }
+        }
+    }
+
+    if (logBuf) {
+        logBuf->flush();
+        metrics.waitNs.store(logBuf->waitedNs(), std::memory_order_relaxed);
+    }
+    stats.busySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+// ─────────────── run `count` seeds on `threads` workers ───────────────
+struct RainRun {
+    std::vector<RainWorkerStats> workers;
+    double   wallSeconds = 0;
+    uint64_t hops = 0;
+};
+
+// With `metrics`, worker t counts into metrics->thread(t) (which must
+// have ≥ threads shards), so a MetricsDumper can watch the run.
+inline RainRun runRain(size_t count, size_t threads, size_t batchSize, std::vector<uint64_t>& primes,
+                       RingLogWriter* logWriter, Metrics* metrics = nullptr) {
+    RainRun run;
+    run.workers.resize(threads);
+    primes.assign(count, 0);
+    SeedScheduler scheduler(count, threads, batchSize);
+    std::unique_ptr<Metrics> local;
+    if (!metrics) {
+        local.reset(new Metrics("prime_rain", "primality_ns", threads));
+        metrics = local.get();
+    }
+    const uint64_t hopsBefore = metrics->total(&ThreadMetrics::hops);
+
+    const auto poolStart = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back(rainWorker, t, std::ref(scheduler), primes.data(), nullptr, logWriter,
+                          std::ref(run.workers[t]), std::ref(metrics->thread(t)));
+    }
+    for (auto& th : pool) th.join();
+    run.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - poolStart).count();
+    run.hops = metrics->total(&ThreadMetrics::hops) - hopsBefore;
+    return run;
+}
+
+// ─────────────── streaming: results to a consumer as they land ───────────────
+// Runs `count` seeds (0 = no end) and calls emit(results, n) on the
+// calling thread with every batch of finished seeds, in completion order.
+// Workers hand results through a bounded queue of `queueCapacity` and
+// block while it is full, so memory stays flat however long the run
+// goes. The run ends when all seeds are done or emit() returns false.
+template <class Emit>
+RainRun streamRain(size_t count, size_t threads, size_t batchSize, size_t queueCapacity, RingLogWriter* logWriter,
+                   Metrics& metrics, Emit&& emit) {
+    RainRun run;
+    run.workers.resize(threads);
+    SeedScheduler scheduler(SharedCursor{}, count, batchSize);   // no per‑batch state: flat memory
+    RainQueue queue(queueCapacity);
+    std::atomic<size_t> running{threads};
+    const uint64_t hopsBefore = metrics.total(&ThreadMetrics::hops);
+
+    const auto poolStart = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            rainWorker(t, scheduler, nullptr, &queue, logWriter, run.workers[t], metrics.thread(t));
+            if (running.fetch_sub(1) == 1) queue.close();      // the last worker out closes the stream
+        });
+    }
+
+    std::vector<RainResult> batch(std::min(queue.capacity(), RAIN_STREAM_BATCH));
+    for (size_t n; (n = queue.popBulk(batch.data(), batch.size())) > 0;) {
+        if (!emit(static_cast<const RainResult*>(batch.data()), n)) {
+            scheduler.stop();
+            queue.close();
+            break;
+        }
+    }
+    for (auto& th : pool) th.join();
+    run.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - poolStart).count();
+    run.hops = metrics.total(&ThreadMetrics::hops) - hopsBefore;
+    return run;
+}
@@ -0,0 +1,261 @@
+// prime_rain_analyze.cpp
+// ---------------------------------------------------------------
+// Summarises a prime rain text log (prime_rain_log.txt) of any size:
+//
+//   • histogram of hops per seed (with mean / median / p99 / max)
+//   • final primes by decade (leading digit × power of ten)
+//   • seeds per thread, from the "(thread …)" tag
+//   • outliers: the seeds that took the most hops
+//
+// The log is mmap'd and cut into one range per thread at "Seed #"
+// block boundaries; each thread parses its blocks on its own and the
+// partial summaries are merged at the end. Only the seed header and
+// the "prime reached" line of a block are parsed — hop lines are
+// skipped with one memmem.
+// For a binary journal, decode it with prime_rain_dump first.
+// ---------------------------------------------------------------
+// Build:   g++ -std=c++17 -O2 -pthread prime_rain_analyze.cpp -o prime_rain_analyze
+// Run:     ./prime_rain_analyze [log] [--threads T] [--top K]
+//   log     = text log            (default prime_rain_log.txt)
+//   threads = parser threads      (default: all cores)
+//   top     = outliers to list    (default 10)
+// ---------------------------------------------------------------
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ───────────────────────────── per-range summary ────────────────────────────
+struct Outlier {
+    uint64_t hops, seed, prime;
+    bool operator<(const Outlier& o) const { return hops != o.hops ? hops > o.hops : seed < o.seed; }
+};
+
+struct Summary {
+    uint64_t seeds = 0;
+    uint64_t incomplete = 0;                       // header without a "prime reached" line
+    uint64_t totalHops = 0;
+    std::vector<uint64_t> hopCounts;               // hopCounts[h] = seeds that took h hops
+    uint64_t decades[21][10] = {};                 // [digits][leading digit]
+    std::unordered_map<std::string, uint64_t> perThread;
+    std::vector<Outlier> top;                      // kept sorted, at most `topK`
+
+    void addOutlier(const Outlier& o, size_t topK) {
+        if (topK == 0 || (top.size() == topK && !(o < top.back()))) return;
+        top.insert(std::upper_bound(top.begin(), top.end(), o), o);
+        if (top.size() > topK) top.pop_back();
+    }
+
+    void merge(const Summary& s, size_t topK) {
+        seeds += s.seeds;
+        incomplete += s.incomplete;
+        totalHops += s.totalHops;
+        if (hopCounts.size() < s.hopCounts.size()) hopCounts.resize(s.hopCounts.size());
+        for (size_t h = 0; h < s.hopCounts.size(); ++h) hopCounts[h] += s.hopCounts[h];
+        for (int d = 0; d < 21; ++d)
+            for (int l = 0; l < 10; ++l) decades[d][l] += s.decades[d][l];
+        for (const auto& kv : s.perThread) perThread[kv.first] += kv.second;
+        for (const Outlier& o : s.top) addOutlier(o, topK);
+    }
+};
+
+// ───────────────────────────────── parsing ──────────────────────────────────
+const char SEED_TAG[]  = "Seed #";
+const char PRIME_TAG[] = "prime reached after ";
+
+inline const char* findText(const char* p, const char* end, const char* text, size_t len) {
+    return static_cast<const char*>(memmem(p, static_cast<size_t>(end - p), text, len));
+}
+
+// Parses digits at p; returns the position after them.
+inline const char* parseNumber(const char* p, const char* end, uint64_t& v) {
+    v = 0;
+    while (p < end && *p >= '0' && *p <= '9') v = v * 10 + static_cast<uint64_t>(*p++ - '0');
+    return p;
+}
+
+void parseRange(const char* begin, const char* end, size_t topK, Summary& s) {
+    const char* p = findText(begin, end, SEED_TAG, sizeof(SEED_TAG) - 1);
+    while (p) {
+        const char* next = findText(p + 1, end, SEED_TAG, sizeof(SEED_TAG) - 1);
+        const char* blockEnd = next ? next : end;
+
+        // "Seed #N (thread T) : ORIGINAL"
+        uint64_t seed;
+        const char* q = parseNumber(p + sizeof(SEED_TAG) - 1, blockEnd, seed);
+        const char* tag = findText(q, blockEnd, "(thread ", 8);
+        const char* tagEnd = tag ? static_cast<const char*>(std::memchr(tag, ')', blockEnd - tag)) : nullptr;
+        if (tagEnd) ++s.perThread[std::string(tag + 8, tagEnd)];
+
+        // "  prime reached after H hops: P"
+        const char* fin = findText(q, blockEnd, PRIME_TAG, sizeof(PRIME_TAG) - 1);
+        uint64_t hops, prime;
+        if (fin) {
+            q = parseNumber(fin + sizeof(PRIME_TAG) - 1, blockEnd, hops);
+            q = static_cast<const char*>(std::memchr(q, ':', blockEnd - q));
+        }
+        if (!fin || !q || q + 2 > blockEnd) {
+            ++s.incomplete;
+        } else {
+            parseNumber(q + 2, blockEnd, prime);
+            ++s.seeds;
+            s.totalHops += hops;
+            if (s.hopCounts.size() <= hops) s.hopCounts.resize(hops + 1);
+            ++s.hopCounts[hops];
+
+            int digits = 1;
+            uint64_t lead = prime;
+            while (lead >= 10) {
+                lead /= 10;
+                ++digits;
+            }
+            ++s.decades[std::min(digits, 20)][lead];
+            s.addOutlier({hops, seed, prime}, topK);
+        }
+        p = next;
+    }
+}
+
+// ──────────────────────────────── report ────────────────────────────────────
+uint64_t percentile(const std::vector<uint64_t>& counts, uint64_t total, double q) {
+    const uint64_t rank = static_cast<uint64_t>(q * (total - 1));
+    uint64_t seen = 0;
+    for (size_t h = 0; h < counts.size(); ++h) {
+        seen += counts[h];
+        if (seen > rank) return h;
+    }
+    return counts.empty() ? 0 : counts.size() - 1;
+}
+
+void printSummary(const Summary& s) {
+    char line[160];
+    std::printf("seeds %llu, hops %llu", static_cast<unsigned long long>(s.seeds),
+                static_cast<unsigned long long>(s.totalHops));
+    if (s.incomplete) std::printf(", %llu incomplete blocks", static_cast<unsigned long long>(s.incomplete));
+    std::printf("\n");
+    if (!s.seeds) return;
+
+    std::printf("\nhops per seed: mean %.2f  median %llu  p99 %llu  max %llu\n",
+                static_cast<double>(s.totalHops) / s.seeds,
+                static_cast<unsigned long long>(percentile(s.hopCounts, s.seeds, 0.5)),
+                static_cast<unsigned long long>(percentile(s.hopCounts, s.seeds, 0.99)),
+                static_cast<unsigned long long>(s.hopCounts.size() - 1));
+    // power-of-two buckets: 0, 1, 2-3, 4-7, ...
+    std::vector<std::pair<uint64_t, uint64_t>> buckets;   // (first hop count, seeds)
+    for (uint64_t h = 0; h < s.hopCounts.size(); ++h) {
+        const uint64_t lo = h < 2 ? h : uint64_t(1) << (63 - __builtin_clzll(h));
+        if (buckets.empty() || buckets.back().first != lo) buckets.push_back({lo, 0});
+        buckets.back().second += s.hopCounts[h];
+    }
+    uint64_t peak = 1;
+    for (const auto& b : buckets) peak = std::max(peak, b.second);
+    for (const auto& b : buckets) {
+        const uint64_t hi = b.first < 2 ? b.first : 2 * b.first - 1;
+        std::snprintf(line, sizeof(line), "  %6llu-%-6llu %12llu  ", static_cast<unsigned long long>(b.first),
+                      static_cast<unsigned long long>(hi), static_cast<unsigned long long>(b.second));
+        std::printf("%s%s\n", line, std::string(static_cast<size_t>(40.0 * b.second / peak + 0.5), '#').c_str());
+    }
+
+    std::printf("\nfinal primes by decade:\n");
+    for (int d = 1; d <= 20; ++d) {
+        for (int l = 1; l < 10; ++l) {
+            if (!s.decades[d][l]) continue;
+            std::printf("  %d%s  %12llu  (%.2f%%)\n", l, std::string(d - 1, 'x').c_str(),
+                        static_cast<unsigned long long>(s.decades[d][l]), 100.0 * s.decades[d][l] / s.seeds);
+        }
+    }
+    if (s.decades[1][0]) std::printf("  0  %12llu\n", static_cast<unsigned long long>(s.decades[1][0]));
+
+    std::printf("\nseeds per thread:\n");
+    std::map<std::string, uint64_t> threads(s.perThread.begin(), s.perThread.end());
+    for (const auto& kv : threads) {
+        std::printf("  %-20s %12llu  (%.2f%%)\n", kv.first.c_str(), static_cast<unsigned long long>(kv.second),
+                    100.0 * kv.second / (s.seeds + s.incomplete));
+    }
+
+    std::printf("\noutliers (most hops):\n");
+    for (const Outlier& o : s.top) {
+        std::printf("  seed #%-12llu %8llu hops -> %llu\n", static_cast<unsigned long long>(o.seed),
+                    static_cast<unsigned long long>(o.hops), static_cast<unsigned long long>(o.prime));
+    }
+}
+
+// ──────────────────────────────── main ──────────────────────────────────────
+int main(int argc, char* argv[]) {
+    std::string path = "prime_rain_log.txt";
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t topK = 10;
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        if (arg == "--threads" && a + 1 < argc)  threads = std::max(1, std::atoi(argv[++a]));
+        else if (arg == "--top" && a + 1 < argc) topK = std::strtoull(argv[++a], nullptr, 10);
+        else if (arg[0] != '-')                  path = arg;
+        else {
+            std::cerr << "Usage: ./prime_rain_analyze [log] [--threads T] [--top K]\n";
+            return 1;
+        }
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat st{};
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        std::cerr << "Cannot open log " << path << "\n";
+        return 1;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    if (size == 0) {
+        std::cerr << "Empty log " << path << "\n";
+        return 1;
+    }
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        std::cerr << "Cannot map log " << path << "\n";
+        return 1;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+    const char* base = static_cast<const char*>(map);
+    const char* end  = base + size;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    // cut at "\nSeed #" so every block belongs to exactly one range
+    threads = std::max<size_t>(1, std::min(threads, size / (1 << 20) + 1));
+    std::vector<const char*> cut{base};
+    for (size_t t = 1; t < threads; ++t) {
+        const char* at = std::max(cut.back(), base + size * t / threads);
+        const char* next = findText(at, end, "\nSeed #", 7);
+        cut.push_back(next ? next + 1 : end);
+    }
+    cut.push_back(end);
+
+    std::vector<Summary> partial(threads);
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back(parseRange, cut[t], cut[t + 1], topK, std::ref(partial[t]));
+    }
+    for (auto& th : pool) th.join();
+
+    Summary total;
+    for (const Summary& s : partial) total.merge(s, topK);
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    const char* nl = static_cast<const char*>(std::memchr(base, '\n', size));
+    std::printf("%s\n", std::string(base, nl ? nl : end).c_str());
+    printSummary(total);
+    std::fprintf(stderr, "\n%.1f MB parsed in %.3f s on %zu threads\n", size / 1e6, sec, threads);
+    munmap(map, size);
+    return 0;
+}
@@ -0,0 +1,132 @@
+// prime_rain_dump.cpp
+// ---------------------------------------------------------------
+// Decodes a binary prime rain hop journal (written with
+// `prime_rain --journal FILE`) back into the familiar text log:
+//
+//   Seed #1 (thread 0) : 43701761
+//     hop    1: ±56816091 -> 10517852
+//     ...
+//     prime reached after 23 hops: 82452521
+//
+// Every block's CRC‑32 is checked; decoding stops at the first bad
+// or truncated block and the exit code says so.
+// ---------------------------------------------------------------
+// Build:   g++ -std=c++17 -O2 prime_rain_dump.cpp -o prime_rain_dump
+// Run:     ./prime_rain_dump [journal] [out.txt]
+//   journal = binary journal (default prime_rain_journal.bin)
+//   out.txt = text output      (default stdout)
+// ---------------------------------------------------------------
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hop_journal.hpp"
+
+int main(int argc, char* argv[]) {
+    const std::string inPath = (argc > 1) ? argv[1] : "prime_rain_journal.bin";
+    FILE* out = (argc > 2) ? std::fopen(argv[2], "wb") : stdout;
+    if (!out) {
+        std::cerr << "Cannot open output file!\n";
+        return 1;
+    }
+
+    int fd = ::open(inPath.c_str(), O_RDONLY);
+    struct stat st{};
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        std::cerr << "Cannot open journal " << inPath << "\n";
+        return 1;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    if (size < sizeof(JournalFileHeader)) {
+        std::cerr << "Not a prime rain journal: " << inPath << "\n";
+        return 1;
+    }
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        std::cerr << "Cannot map journal " << inPath << "\n";
+        return 1;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+    const auto* base = static_cast<const unsigned char*>(map);
+
+    JournalFileHeader fh;
+    std::memcpy(&fh, base, sizeof(fh));
+    if (std::memcmp(fh.magic, JOURNAL_MAGIC, sizeof(fh.magic)) != 0 || fh.version != JOURNAL_VERSION) {
+        std::cerr << "Not a prime rain journal (or unsupported version): " << inPath << "\n";
+        return 1;
+    }
+
+    std::string text = "Prime‑Rain log — " + std::to_string(fh.seeds) + " seeds with " +
+                       std::to_string(fh.threads) + " threads (master seed " +
+                       std::to_string(fh.masterSeed) + ")\n\n";
+    std::string carry;                      // record bytes cut off by a block boundary
+    JournalRecord rec;
+    size_t records = 0;
+    int status = 0;
+
+    size_t off = sizeof(JournalFileHeader);
+    while (off < size) {
+        JournalBlockHeader bh;
+        if (size - off < sizeof(bh)) {
+            std::cerr << "Truncated block header at offset " << off << "\n";
+            status = 1;
+            break;
+        }
+        std::memcpy(&bh, base + off, sizeof(bh));
+        off += sizeof(bh);
+        if (bh.magic != JOURNAL_BLOCK_MAGIC || bh.bytes > size - off) {
+            std::cerr << "Corrupt or truncated block at offset " << off - sizeof(bh) << "\n";
+            status = 1;
+            break;
+        }
+        const unsigned char* payload = base + off;
+        if (crc32(payload, bh.bytes) != bh.crc) {
+            std::cerr << "Checksum mismatch in block at offset " << off - sizeof(bh) << "\n";
+            status = 1;
+            break;
+        }
+        off += bh.bytes;
+
+        // decode straight from the mapping unless a record straddles the boundary
+        const unsigned char* p = payload;
+        size_t len = bh.bytes;
+        if (!carry.empty()) {
+            carry.append(reinterpret_cast<const char*>(payload), bh.bytes);
+            p   = reinterpret_cast<const unsigned char*>(carry.data());
+            len = carry.size();
+        }
+        JournalCursor cur(p, len);
+        const unsigned char* start = cur.position();
+        while (readJournalRecord(cur, rec)) {
+            formatJournalRecord(text, rec, fh.lower, fh.upper);
+            ++records;
+            start = cur.position();
+        }
+        std::string rest(reinterpret_cast<const char*>(start), static_cast<size_t>(p + len - start));
+        carry.swap(rest);
+
+        if (text.size() >= (1 << 20)) {
+            std::fwrite(text.data(), 1, text.size(), out);
+            text.clear();
+        }
+    }
+    if (status == 0 && !carry.empty()) {
+        std::cerr << "Journal ends in the middle of a record\n";
+        status = 1;
+    }
+
+    std::fwrite(text.data(), 1, text.size(), out);
+    if (out != stdout) std::fclose(out);
+    munmap(map, size);
+
+    std::cerr << records << " seed records decoded from " << inPath << "\n";
+    return status;
+}
@@ -7,10 +7,13 @@
 // splashed into a log file (prime_rain_log.txt) so you can replay
 // the whole tempest later.
 // ---------------------------------------------------------------
-// Build:   g++ -std=c++17 -O2 prime_rain_generator.cpp -o prime_rain
+// Build:   g++ -std=c++17 -O2 -pthread prime_rain_generator.cpp -o prime_rain
 // Run:     ./prime_rain [count]
 //   where  count = how many initial 8‑digit numbers you want (default 20)
 // ---------------------------------------------------------------
+// Primality comes from an odd‑only bitmap of the 8‑digit range that is
+// sieved once (prime_bitmap_10000000_99999999.bin) and mmap'd afterwards.
+// ---------------------------------------------------------------
 // Fun fact printed at the end: how many raindrops (adjustments) on
 // average it took before finding a prime.
 // ---------------------------------------------------------------
@@ -22,9 +25,16 @@
 #include <fstream>
 #include <cmath>
 #include <iomanip>
+#include <thread>
+
+#include "prime_bitmap.hpp"
+
+PrimeBitmap primeBitmap;
 
 // ---------- quick & dirty primality check (deterministic for < 10^9) ---------
+// Single bit lookup inside the mapped range, trial division outside it.
 bool isPrime(uint32_t n) {
+    if (primeBitmap.contains(n)) return primeBitmap.test(n);
     if (n < 2) return false;
     if (n % 2 == 0) return n == 2;
     if (n % 3 == 0) return n == 3;
@@ -41,6 +51,11 @@ int main(int argc, char* argv[]) {
     const uint32_t UPPER = 99999999;     // largest  8‑digit number
     size_t count = (argc > 1) ? std::stoul(argv[1]) : 20;
 
+    if (!primeBitmap.loadOrBuild(PrimeBitmap::defaultPath(LOWER, UPPER), LOWER, UPPER,
+                                 std::max(1u, std::thread::hardware_concurrency()))) {
+        std::cerr << "Prime bitmap unavailable, falling back to trial division.\n";
+    }
+
     // rng setup
     std::mt19937 rng(static_cast<uint32_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
     std::uniform_int_distribution<uint32_t> dist8(LOWER, UPPER);
@@ -1,139 +1,504 @@
-// prime_rain_generator.cpp — v2
+// prime_rain_generator2v.cpp — v2
 // ---------------------------------------------------------------
-// Multithreaded “Make‑it‑rain” generator for 8‑digit primes.
-// For every random 8‑digit seed, we keep nudging it with *another* random
-// 8‑digit delta (add or subtract) until we land on a prime.  Every hop is
-// recorded to prime_rain_log.txt, guarded by a mutex so multiple threads
-// can party in the same file without stepping on each other’s confetti.
+// Multithreaded “Make‑it‑rain” generator for N‑digit primes (8 by default).
+// For every random N‑digit seed, we keep nudging it with *another* random
+// N‑digit delta (add or subtract) until we land on a prime.  Every hop is
+// recorded to prime_rain_log.txt: each worker buffers its own lines and
+// feeds a lock‑free ring that one writer thread drains into the file,
+// so threads party in the same log without queueing on a mutex.
 // ---------------------------------------------------------------
-// Build:   g++ -std=c++17 -O2 -pthread prime_rain_generator.cpp -o prime_rain
-// Run:     ./prime_rain [count] [threads]
-//   count   = how many seeds in total (default 100)
-//   threads = #worker threads        (default hw_concurrency)
+// Build:   g++ -std=c++17 -O2 -pthread prime_rain_generator2v.cpp -o prime_rain
+// Run:     ./prime_rain [count] [threads] [--digits N]
+//                       [--ring-kb KB] [--overflow block|drop] [--batch N]
+//                       [--journal FILE] [--seed S] [--replay #]
+//                       [--sample | --nearest next|prev]
+//                       [--metrics FILE] [--metrics-every SEC]
+//                       [--stream text|binary] [--queue N]
+//   count    = how many seeds in total (default 100)
+//   threads  = #worker threads        (default hw_concurrency)
+//   digits   = width of seeds/primes, 2..19 (default 8)
+//   ring-kb  = per‑worker log ring size in KiB (default 1024)
+//   overflow = full ring: wait for the writer, or drop the chunk (default block)
+//   batch    = seeds per work‑stealing batch (default 32)
+//   journal  = write a compact binary hop journal (hop_journal.hpp) to FILE
+//              instead of the text log; prime_rain_dump turns it back into text
+//   seed     = 64‑bit master seed (default: random, printed at the end)
+//   replay   = with --seed, recompute just seed #N's journey and print it
+//   sample   = no walk: seed #i is the k‑th prime of the range for a
+//              uniform random k, picked through a rank/select index
+//              (prime_rank_select.hpp) — uniform over primes, flat cost
+//   nearest  = no walk: jump from seed #i's random start to the next /
+//              previous prime with the same index (both ≤ 9 digits only)
+//   metrics  = rewrite FILE every few seconds with per‑thread seeds, hops,
+//              primality tests and latency, log bytes and log wait time
+//              (metrics.hpp): JSON if FILE ends in .json, else Prometheus
+//   metrics-every = seconds between metrics dumps (default 5)
+//   stream   = no log, no finale: write each prime to stdout the moment
+//              its seed finishes, one decimal per line (text) or as a
+//              host‑order uint64 (binary), in completion order; with no
+//              count (or 0) it runs until stopped or the reader goes away
+//   queue    = --stream: finished primes held between workers and stdout
+//              (default 65536); when full the workers wait
+// ---------------------------------------------------------------
+// Up to 9 digits the range is sieved once into an odd‑only bitmap
+// (e.g. prime_bitmap_10000000_99999999.bin, ~5.6 MB) by all worker
+// threads; later runs mmap it and isPrime() is a single bit lookup.
+// Wider ranges use deterministic 64‑bit Miller–Rabin (primality.hpp).
+// Each worker walks 16 seeds side by side and draws each seed's next
+// few hops ahead of time; a mod‑30030 wheel drops ~81 % of those
+// candidates and the ≤ 9‑digit survivors go through the AVX‑512/AVX2
+// batch sieve (prime_batch.hpp) together. The log is unchanged: only
+// the hops up to each seed's first prime are recorded.
+// Seeds are handed out in small batches by a work‑stealing scheduler
+// (work_stealing.hpp); a per‑thread utilization table closes the run.
+// Randomness is counter‑based (rain_rng.hpp): seed #i's journey depends
+// only on (master seed, i), so runs replay exactly at any thread count.
 // ---------------------------------------------------------------
 // Finale: a glorious ANSI‑color confetti shower plus stats on how many
-// 8‑digit raindrops each seed needed on average. Enjoy! 🌈💧🔢
+// raindrops each seed needed on average. Enjoy! 🌈💧🔢
 // ---------------------------------------------------------------
 
 #include <iostream>
 #include <vector>
 #include <random>
-#include <chrono>
-#include <fstream>
-#include <cmath>
 #include <iomanip>
-#include <mutex>
 #include <thread>
-#include <atomic>
-
-// ─────────────────── primality (deterministic < 2^32) ───────────────────────
-bool isPrime(uint32_t n) {
-    if (n < 2) return false;
-    if (n % 2 == 0) return n == 2;
-    if (n % 3 == 0) return n == 3;
-    uint32_t r = static_cast<uint32_t>(std::sqrt(n));
-    for (uint32_t f = 5; f <= r; f += 6) {
-        if (n % f == 0 || n % (f + 2) == 0) return false;
-    }
-    return true;
-}
+#include <cstring>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <memory>
 
-// ───────────────────────── global stuff ─────────────────────────────────────
-constexpr uint32_t LOWER = 10000000;      // 8‑digit range
-constexpr uint32_t UPPER = 99999999;
+#include <cerrno>
+#include <csignal>
 
-std::mutex logMutex;
-std::ofstream logFile("prime_rain_log.txt");
+#include <fcntl.h>
+#include <unistd.h>
 
-std::atomic<size_t> totalHops{0};
+#include "prime_rain.hpp"
+#include "prime_rank_select.hpp"
 
-// ────────────────── worker that handles a slice of seeds ────────────────────
-void rainWorker(size_t startIdx, size_t endIdx, std::vector<uint32_t>& primes) {
-    // thread‑local RNG
-    std::mt19937 rng(static_cast<uint32_t>(
-        std::chrono::steady_clock::now().time_since_epoch().count() + startIdx));
-    std::uniform_int_distribution<uint32_t> dist8(LOWER, UPPER);
-    std::bernoulli_distribution flip(0.5);
+// ───────────── Funky ANSI‑color confetti finale ──────────────
+void rainConfetti(const std::vector<uint64_t>& primes) {
+    const char* colors[] = {"\033[31m", "\033[32m", "\033[33m", "\033[34m", "\033[35m", "\033[36m"};
+    constexpr size_t C = sizeof(colors)/sizeof(colors[0]);
 
-    for (size_t i = startIdx; i < endIdx; ++i) {
-        uint32_t n = dist8(rng);
-        uint32_t original = n;
-        size_t hops = 0;
+    std::cout << "\n\033[1m\033[7m=>  IT'S  RAINING  " << DIGITS << "‑DIGIT  PRIMES!  <=\033[0m\n\n";
+    for (size_t i = 0; i < primes.size(); ++i) {
+        std::cout << colors[i % C] << primes[i] << " \033[0m";
+        if ((i + 1) % 5 == 0) std::cout << "\n";
+    }
+}
+
+// ─────────────── --sample / --nearest: primes by rank/select, no walk ───────────────
+enum class DirectMode { Sample, Next, Prev };
+
+// Seed #i gets either a uniform prime index k_i (the k‑th prime of the
+// range) or a uniform start n_i and the prime next to it. Both are one
+// rank/select lookup, so every seed costs the same. Seeds are split into
+// rounds; within a round each thread takes one contiguous slice and the
+// slices are written in order, so the log lists seeds in order and the
+// primes are the same at any thread count.
+struct DirectRun {
+    double   wallSeconds = 0;
+    uint64_t distance    = 0;   // --nearest: sum of |prime − start|
+    bool     ok          = true;
+};
 
-        {
-            std::lock_guard<std::mutex> lk(logMutex);
-            logFile << "Seed #" << i + 1 << " (thread " << std::this_thread::get_id() << ") : " << original << "\n";
+DirectRun runDirect(DirectMode mode, const PrimeRankSelect& index, size_t count, size_t threads,
+                    std::vector<uint64_t>& primes, int logFd, Metrics& metrics) {
+    constexpr size_t ROUND = size_t(1) << 20;
+    const RainRng pick = mode == DirectMode::Sample ? RainRng(MASTER_SEED, 0, index.count() - 1)
+                                                    : RainRng(MASTER_SEED, LOWER, UPPER);
+    primes.assign(count, 0);
+    std::vector<std::string> logs(threads);
+    std::vector<uint64_t> distance(threads, 0);
+    DirectRun run;
+
+    auto slice = [&](size_t t, size_t begin, size_t end) {
+        std::string& log = logs[t];
+        log.clear();
+        char line[128];
+        for (size_t i = begin; i < end; ++i) {
+            const uint64_t x = pick.start(i);
+            uint64_t p;
+            int len;
+            if (mode == DirectMode::Sample) {
+                p = index.prime(x);
+                len = std::snprintf(line, sizeof(line), "Seed #%zu (thread %zu) : prime #%llu = %llu\n", i + 1, t,
+                                    static_cast<unsigned long long>(x + 1), static_cast<unsigned long long>(p));
+            } else {
+                p = mode == DirectMode::Next ? index.nextPrime(x) : index.prevPrime(x);
+                distance[t] += p > x ? p - x : x - p;
+                len = std::snprintf(line, sizeof(line), "Seed #%zu (thread %zu) : %llu -> %s prime %llu\n", i + 1, t,
+                                    static_cast<unsigned long long>(x), mode == DirectMode::Next ? "next" : "prev",
+                                    static_cast<unsigned long long>(p));
+            }
+            primes[i] = p;
+            if (logFd >= 0) log.append(line, static_cast<size_t>(len));
         }
+        ThreadMetrics::add(metrics.thread(t).seeds, end - begin);
+        ThreadMetrics::add(metrics.thread(t).logBytes, log.size());
+    };
 
-        while (!isPrime(n)) {
-            uint32_t delta = dist8(rng);              // 8‑digit hop
-            int64_t signedN = static_cast<int64_t>(n);
-            int64_t signedDelta = static_cast<int64_t>(delta);
-            signedN += flip(rng) ? signedDelta : -signedDelta;
-
-            // wrap back into 8‑digit range
-            signedN = (signedN - LOWER) % (UPPER - LOWER + 1);
-            if (signedN < 0) signedN += (UPPER - LOWER + 1);
-            n = static_cast<uint32_t>(signedN + LOWER);
-
-            ++hops;
-            {
-                std::lock_guard<std::mutex> lk(logMutex);
-                logFile << "  hop " << std::setw(4) << hops << ": ±" << delta << " -> " << n << "\n";
+    const auto t0 = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < count && run.ok; round += ROUND) {
+        const size_t n = std::min(ROUND, count - round);
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < threads; ++t) {
+            pool.emplace_back(slice, t, round + n * t / threads, round + n * (t + 1) / threads);
+        }
+        slice(0, round, round + n / threads);
+        for (auto& th : pool) th.join();
+        for (const std::string& log : logs) {
+            if (!log.empty() && ::write(logFd, log.data(), log.size()) != static_cast<ssize_t>(log.size())) {
+                run.ok = false;
             }
         }
+    }
+    run.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    for (uint64_t d : distance) run.distance += d;
+    return run;
+}
+
+// ─────────────── --stream: primes to stdout as they are found ───────────────
+enum class StreamFormat { Text, Binary };
 
-        {
-            std::lock_guard<std::mutex> lk(logMutex);
-            logFile << "  prime reached after " << hops << " hops: " << n << "\n\n";
+volatile std::sig_atomic_t streamInterrupted = 0;
+extern "C" void onStreamSignal(int) { streamInterrupted = 1; }
+
+struct StreamOutcome {
+    uint64_t seeds = 0;
+    uint64_t hops  = 0;
+    int      error = 0;      // errno of a failed write (EPIPE: the reader went away)
+};
+
+// Writes results to fd in buffered chunks, flushing whenever the queue
+// has run dry so a slow trickle still reaches the reader at once.
+// Returns false (stop the run) on a write error or SIGINT / SIGTERM.
+class StreamEmitter {
+public:
+    StreamEmitter(int fd, StreamFormat format, StreamOutcome& outcome) : fd_(fd), format_(format), out_(outcome) {
+        buf_.reserve(BUFFER + 32);
+    }
+
+    bool operator()(const RainResult* results, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            if (format_ == StreamFormat::Binary) {
+                buf_.append(reinterpret_cast<const char*>(&results[i].prime), sizeof(uint64_t));
+            } else {
+                char line[24];
+                const int len = std::snprintf(line, sizeof(line), "%llu\n",
+                                              static_cast<unsigned long long>(results[i].prime));
+                buf_.append(line, static_cast<size_t>(len));
+            }
+            ++out_.seeds;
+            out_.hops += results[i].hops;
+            if (buf_.size() >= BUFFER && !flush()) return false;
         }
+        // a short batch means the queue is empty: hand over what we have
+        if (n < RAIN_STREAM_BATCH && !flush()) return false;
+        return !streamInterrupted;
+    }
 
-        totalHops += hops;
-        primes[i] = n;
+    bool flush() {
+        for (size_t done = 0; done < buf_.size();) {
+            const ssize_t w = ::write(fd_, buf_.data() + done, buf_.size() - done);
+            if (w < 0 && errno == EINTR) {
+                if (streamInterrupted) break;
+                continue;
+            }
+            if (w <= 0) {
+                out_.error = w < 0 ? errno : EIO;
+                buf_.clear();
+                return false;
+            }
+            done += static_cast<size_t>(w);
+        }
+        buf_.clear();
+        return true;
     }
-}
+
+private:
+    static constexpr size_t BUFFER = 64 << 10;
+
+    int fd_;
+    StreamFormat format_;
+    StreamOutcome& out_;
+    std::string buf_;
+};
 
 // ──────────────────────────── main ──────────────────────────────────────────
 int main(int argc, char* argv[]) {
-    if (!logFile) {
-        std::cerr << "Cannot open log file!\n";
-        return 1;
+    std::string logPath = "prime_rain_log.txt";
+    size_t ringKb = 1024;
+    size_t batchSize = 32;
+    OverflowPolicy overflow = OverflowPolicy::Block;
+    bool   seedGiven = false;
+    size_t replay    = 0;                 // 1‑based seed number to recompute, 0 = normal run
+    int    digits    = 8;
+    std::string metricsPath;              // --metrics: periodic JSON / Prometheus dump
+    double metricsEvery = 5;
+    bool   direct    = false;             // --sample / --nearest instead of the hop walk
+    DirectMode directMode = DirectMode::Sample;
+    bool   stream    = false;             // --stream: primes to stdout, no log
+    StreamFormat streamFormat = StreamFormat::Text;
+    size_t queueCapacity = 65536;
+
+    // positional [count] [threads], plus --flags anywhere
+    std::vector<std::string> positional;
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        if (arg == "--digits" && a + 1 < argc) {
+            digits = std::stoi(argv[++a]);
+        } else if (arg == "--seed" && a + 1 < argc) {
+            MASTER_SEED = std::stoull(argv[++a]);
+            seedGiven = true;
+        } else if (arg == "--replay" && a + 1 < argc) {
+            replay = std::stoul(argv[++a]);
+        } else if (arg == "--metrics" && a + 1 < argc) {
+            metricsPath = argv[++a];
+        } else if (arg == "--metrics-every" && a + 1 < argc) {
+            metricsEvery = std::stod(argv[++a]);
+        } else if (arg == "--sample") {
+            direct = true;
+            directMode = DirectMode::Sample;
+        } else if (arg == "--nearest" && a + 1 < argc) {
+            std::string which = argv[++a];
+            if (which == "next")      directMode = DirectMode::Next;
+            else if (which == "prev") directMode = DirectMode::Prev;
+            else {
+                std::cerr << "Nearest must be next or prev.\n";
+                return 1;
+            }
+            direct = true;
+        } else if (arg == "--stream" && a + 1 < argc) {
+            std::string format = argv[++a];
+            if (format == "text")        streamFormat = StreamFormat::Text;
+            else if (format == "binary") streamFormat = StreamFormat::Binary;
+            else {
+                std::cerr << "Stream format must be text or binary.\n";
+                return 1;
+            }
+            stream = true;
+        } else if (arg == "--queue" && a + 1 < argc) {
+            queueCapacity = std::max<size_t>(2, std::stoul(argv[++a]));
+        } else if (arg == "--journal" && a + 1 < argc) {
+            logPath = argv[++a];
+            rainLog = RainLog::Journal;
+        } else if (arg == "--batch" && a + 1 < argc) {
+            batchSize = std::max<size_t>(1, std::stoul(argv[++a]));
+        } else if (arg == "--ring-kb" && a + 1 < argc) {
+            ringKb = std::max<size_t>(4, std::stoul(argv[++a]));
+        } else if (arg == "--overflow" && a + 1 < argc) {
+            std::string policy = argv[++a];
+            if (policy == "block")     overflow = OverflowPolicy::Block;
+            else if (policy == "drop") overflow = OverflowPolicy::Drop;
+            else {
+                std::cerr << "Overflow policy must be block or drop.\n";
+                return 1;
+            }
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
     }
 
-    size_t count   = (argc > 1) ? std::stoul(argv[1]) : 100;
-    size_t threads = (argc > 2) ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+    // --stream without a count (or with 0) never stops on its own
+    size_t count   = (positional.size() > 0) ? std::stoul(positional[0]) : (stream ? 0 : 100);
+    size_t threads = (positional.size() > 1) ? std::stoul(positional[1]) : std::thread::hardware_concurrency();
     threads = std::max<size_t>(1, threads);
 
-    logFile << "Prime‑Rain log — " << count << " seeds with " << threads << " threads\n\n";
+    if (!setRainDigits(digits)) {
+        std::cerr << "Digit width must be between 2 and 19.\n";
+        return 1;
+    }
+
+    if (replay != 0 && !seedGiven) {
+        std::cerr << "--replay needs the run's --seed (printed at the end of every run).\n";
+        return 1;
+    }
+    if (stream && (direct || replay != 0 || rainLog == RainLog::Journal)) {
+        std::cerr << "--stream writes primes only: no --sample / --nearest, --replay or --journal.\n";
+        return 1;
+    }
+    if (!seedGiven) {
+        std::random_device rd;
+        MASTER_SEED = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    }
 
-    std::vector<uint32_t> primes(count);
-    std::vector<std::thread> pool;
-    size_t chunk = (count + threads - 1) / threads;
+    // the bitmap is only worth it while the range fits in 32 bits (≤ 9 digits)
+    if (UPPER <= UINT32_MAX && !loadRainBitmap(threads)) {
+        std::cerr << "Prime bitmap unavailable, falling back to Miller–Rabin.\n";
+    }
 
-    for (size_t t = 0; t < threads; ++t) {
-        size_t start = t * chunk;
-        size_t end   = std::min(count, start + chunk);
-        if (start >= end) break;
-        pool.emplace_back(rainWorker, start, end, std::ref(primes));
+    // ───────────── --replay: recompute one seed's journey, nothing else ─────────────
+    if (replay != 0) {
+        const RainRng rng(MASTER_SEED, LOWER, UPPER);
+        const size_t idx = replay - 1;
+        uint64_t n = rng.start(idx);
+        std::cout << "Seed #" << replay << " (master seed " << MASTER_SEED << ") : " << n << "\n";
+        size_t hops = 0;
+        while (!isPrime(n)) {
+            const RainStep step = rng.step(idx, ++hops);
+            n = rainHop(n, step.delta, step.add, LOWER, UPPER);
+            std::cout << "  hop " << std::setw(4) << hops << ": " << (step.add ? '+' : '-') << step.delta
+                      << " -> " << n << "\n";
+        }
+        std::cout << "  prime reached after " << hops << " hops: " << n << "\n";
+        return 0;
     }
 
-    for (auto& th : pool) th.join();
+    // ───────────── --stream: workers → bounded queue → stdout ─────────────
+    if (stream) {
+        rainLog = RainLog::None;
+        std::signal(SIGPIPE, SIG_IGN);                   // a vanished reader shows up as EPIPE
+        std::signal(SIGINT, onStreamSignal);
+        std::signal(SIGTERM, onStreamSignal);
 
-    double avgHops = static_cast<double>(totalHops) / count;
+        Metrics metrics("prime_rain", "primality_ns", threads);
+        std::unique_ptr<MetricsDumper> dumper;
+        if (!metricsPath.empty()) {
+            dumper.reset(new MetricsDumper(metrics, metricsPath, metricsEvery));
+            dumper->start();
+        }
+        StreamOutcome outcome;
+        StreamEmitter emit(STDOUT_FILENO, streamFormat, outcome);
+        const RainRun run = streamRain(count, threads, batchSize, queueCapacity, nullptr, metrics, emit);
+        emit.flush();
+        const bool metricsOk = !dumper || dumper->stop();
 
-    // ───────────── Funky ANSI‑color confetti finale ──────────────
-    const char* colors[] = {"\033[31m", "\033[32m", "\033[33m", "\033[34m", "\033[35m", "\033[36m"};
-    constexpr size_t C = sizeof(colors)/sizeof(colors[0]);
+        std::cerr << outcome.seeds << " primes streamed in " << std::fixed << std::setprecision(3)
+                  << run.wallSeconds << " s, " << std::setprecision(2)
+                  << (outcome.seeds ? static_cast<double>(outcome.hops) / outcome.seeds : 0.0)
+                  << " hops per seed (master seed " << MASTER_SEED << ")\n";
+        const bool outputOk = outcome.error == 0 || outcome.error == EPIPE;
+        if (!outputOk) std::cerr << "(Output write failed: " << std::strerror(outcome.error) << ")\n";
+        if (!metricsOk) std::cerr << "(Could not write metrics to " << metricsPath << ")\n";
+        return outputOk ? 0 : 1;
+    }
 
-    std::cout << "\n\033[1m\033[7m=>  IT'S  RAINING  8‑DIGIT  PRIMES!  <=\033[0m\n\n";
-    for (size_t i = 0; i < primes.size(); ++i) {
-        std::cout << colors[i % C] << primes[i] << " \033[0m";
-        if ((i + 1) % 5 == 0) std::cout << "\n";
+    if (direct && (rainLog == RainLog::Journal || replay != 0)) {
+        std::cerr << "--sample / --nearest write the text log only and cannot be replayed.\n";
+        return 1;
+    }
+    PrimeRankSelect primeIndex;
+    if (direct && !primeIndex.build(primeBitmap)) {
+        std::cerr << "--sample / --nearest need the prime bitmap (at most 9 digits).\n";
+        return 1;
+    }
+
+    int logFd = ::open(logPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (logFd < 0) {
+        std::cerr << "Cannot open log file!\n";
+        return 1;
+    }
+
+    Metrics metrics("prime_rain", "primality_ns", threads);
+    std::unique_ptr<MetricsDumper> dumper;
+    if (!metricsPath.empty()) {
+        dumper.reset(new MetricsDumper(metrics, metricsPath, metricsEvery));
+        dumper->start();
+    }
+
+    // ───────────── --sample / --nearest: one lookup per seed ─────────────
+    if (direct) {
+        const char* what = directMode == DirectMode::Sample ? "uniform prime samples"
+                         : directMode == DirectMode::Next   ? "seeds to their next prime"
+                                                            : "seeds to their previous prime";
+        const std::string header = "Prime‑Rain log — " + std::to_string(count) + " " + what + " with " +
+                                   std::to_string(threads) + " threads (master seed " +
+                                   std::to_string(MASTER_SEED) + ")\n\n";
+        if (::write(logFd, header.data(), header.size()) != static_cast<ssize_t>(header.size())) {
+            std::cerr << "Cannot write log file!\n";
+            return 1;
+        }
+        std::vector<uint64_t> primes;
+        const DirectRun run = runDirect(directMode, primeIndex, count, threads, primes, logFd, metrics);
+        const bool metricsOk = !dumper || dumper->stop();
+        ::close(logFd);
+
+        rainConfetti(primes);
+        std::cout << "\n\n" << std::fixed << std::setprecision(1) << primeIndex.count() << " primes indexed, "
+                  << (count ? 1e9 * run.wallSeconds / count : 0.0) << " ns per prime on " << threads
+                  << " threads\n";
+        if (directMode != DirectMode::Sample && count) {
+            std::cout << "Average distance from seed to prime: " << std::setprecision(2)
+                      << static_cast<double>(run.distance) / count << "\n";
+        }
+        std::cout << "Master seed: " << MASTER_SEED << "\n";
+        std::cout << (run.ok ? "(Full run logged to " + logPath + ")" : "(Log write failed — " + logPath + " is incomplete)")
+                  << "\n";
+        if (!metricsOk) std::cout << "(Could not write metrics to " << metricsPath << ")\n";
+        return 0;
+    }
+    std::string header;
+    if (rainLog == RainLog::Journal) {
+        JournalFileHeader fh{};
+        std::memcpy(fh.magic, JOURNAL_MAGIC, sizeof(fh.magic));
+        fh.version = JOURNAL_VERSION;
+        fh.digits  = static_cast<uint32_t>(DIGITS);
+        fh.lower   = LOWER;
+        fh.upper   = UPPER;
+        fh.seeds   = count;
+        fh.threads = static_cast<uint32_t>(threads);
+        fh.masterSeed = MASTER_SEED;
+        header.assign(reinterpret_cast<const char*>(&fh), sizeof(fh));
+    } else {
+        header = "Prime‑Rain log — " + std::to_string(count) + " seeds with " +
+                 std::to_string(threads) + " threads (master seed " + std::to_string(MASTER_SEED) + ")\n\n";
     }
+    if (::write(logFd, header.data(), header.size()) != static_cast<ssize_t>(header.size())) {
+        std::cerr << "Cannot write log file!\n";
+        return 1;
+    }
+
+    RingLogWriter logWriter(logFd, threads, ringKb << 10, overflow);
+    if (rainLog == RainLog::Journal) logWriter.setFramer(journalBlockHeader);
+    logWriter.start();
+
+    std::vector<uint64_t> primes;
+    const RainRun run = runRain(count, threads, batchSize, primes, &logWriter, &metrics);
+    const auto& stats = run.workers;
+    const double wall = run.wallSeconds;
+    logWriter.stop();
+    ::close(logFd);
+    const bool metricsOk = !dumper || dumper->stop();
+
+    double avgHops = static_cast<double>(run.hops) / count;
+
+    rainConfetti(primes);
     std::cout << "\n\nAverage hops per seed: " << std::fixed << std::setprecision(2) << avgHops << "\n";
 
     std::cout << (avgHops < 3 ? "Lucky cloud! 🌧️" : "Primes played hard‑to‑get today. ⚡") << "\n";
-    std::cout << "(Full journey logged to prime_rain_log.txt)\n";
+    std::cout << "Master seed: " << MASTER_SEED << "  (replay any seed with --seed " << MASTER_SEED
+              << " --replay <#>)\n";
+    // ───────────── per‑thread utilization (busy time / pool wall time) ─────────────
+    double busyTotal = 0;
+    std::cout << "\nThread  seeds  batches  stolen   busy(s)  util\n";
+    for (size_t t = 0; t < stats.size(); ++t) {
+        const auto& st = stats[t];
+        busyTotal += st.busySeconds;
+        std::cout << std::setw(6) << t << std::setw(7) << st.seeds << std::setw(9) << st.batches
+                  << std::setw(8) << st.stolen << std::setw(10) << std::setprecision(3) << st.busySeconds
+                  << std::setw(5) << std::setprecision(0) << (wall > 0 ? 100.0 * st.busySeconds / wall : 100.0)
+                  << "%\n";
+    }
+    std::cout << "Wall " << std::setprecision(3) << wall << " s vs. total work / threads "
+              << busyTotal / stats.size() << " s\n";
+
+    if (logWriter.failed()) {
+        std::cout << "(Log write failed — " << logPath << " is incomplete)\n";
+    } else if (uint64_t dropped = logWriter.droppedBytes()) {
+        std::cout << "(Journey logged to " << logPath << ", " << dropped << " bytes dropped on ring overflow)\n";
+    } else {
+        std::cout << "(Full journey logged to " << logPath << ")\n";
+    }
+    if (!metricsPath.empty()) {
+        std::cout << (metricsOk ? "(Metrics in " : "(Could not write metrics to ") << metricsPath << ")\n";
+    }
 
     return 0;
 }
@@ -0,0 +1,117 @@
+// rain_rng.hpp
+// ---------------------------------------------------------------
+// Counter‑based randomness for prime rain.
+// Philox4x32‑10 (Salmon et al., "Parallel random numbers: as easy as
+// 1, 2, 3") maps (key, counter) → 128 random bits with no state in
+// between. Keying it with the master seed and counting with
+// (seed index, hop index) means any seed's journey can be recomputed
+// on its own, and the result never depends on which thread — or how
+// many threads — walked it.
+// ---------------------------------------------------------------
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// ─────────────────────────────── Philox4x32‑10 ────────────────────────────────
+struct Philox4x32 {
+    using Counter = std::array<uint32_t, 4>;
+    using Key     = std::array<uint32_t, 2>;
+
+    static Counter generate(Counter c, Key k) {
+        for (int round = 0; round < 10; ++round) {
+            const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c[0];
+            const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c[2];
+            c = {static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k[0], static_cast<uint32_t>(p1),
+                 static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k[1], static_cast<uint32_t>(p0)};
+            k[0] += 0x9E3779B9u;
+            k[1] += 0xBB67AE85u;
+        }
+        return c;
+    }
+};
+
+// ─────────────────────── the draws a prime rain walk needs ───────────────────────
+struct RainStep {
+    uint64_t delta;   // in [lower, upper]
+    bool     add;     // add (true) or subtract (false)
+};
+
+class RainRng {
+public:
+    RainRng(uint64_t masterSeed, uint64_t lower, uint64_t upper)
+        : key_{static_cast<uint32_t>(masterSeed), static_cast<uint32_t>(masterSeed >> 32)},
+          lower_(lower), span_(upper - lower + 1), threshold_(-span_ % span_) {}
+
+    // Starting value of seed `index` (hop 0).
+    uint64_t start(uint64_t index) const { return lower_ + draw(index, 0).value; }
+
+    // The `hop`‑th adjustment of seed `index` (hop ≥ 1).
+    RainStep step(uint64_t index, uint64_t hop) const {
+        const Draw d = draw(index, hop);
+        return {lower_ + d.value, d.bit};
+    }
+
+    // Hops hop … hop + K − 1 of seed `index`, the same values step() gives.
+    // The ten Philox rounds run side by side over the K counters, which
+    // the compiler turns into vector multiplies; a draw that hits the
+    // rejection sliver falls back to step().
+    template <size_t K>
+    void steps(uint64_t index, uint64_t hop, RainStep* out) const {
+        uint32_t c0[K], c1[K], c2[K], c3[K];
+        for (size_t j = 0; j < K; ++j) {
+            c0[j] = static_cast<uint32_t>(hop + j);
+            c1[j] = 0;
+            c2[j] = static_cast<uint32_t>(index);
+            c3[j] = static_cast<uint32_t>(index >> 32);
+        }
+        Philox4x32::Key k = key_;
+        for (int round = 0; round < 10; ++round) {
+            for (size_t j = 0; j < K; ++j) {
+                const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0[j];
+                const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2[j];
+                c0[j] = static_cast<uint32_t>(p1 >> 32) ^ c1[j] ^ k[0];
+                c1[j] = static_cast<uint32_t>(p1);
+                c2[j] = static_cast<uint32_t>(p0 >> 32) ^ c3[j] ^ k[1];
+                c3[j] = static_cast<uint32_t>(p0);
+            }
+            k[0] += 0x9E3779B9u;
+            k[1] += 0xBB67AE85u;
+        }
+        for (size_t j = 0; j < K; ++j) {
+            const uint64_t x = (static_cast<uint64_t>(c0[j]) << 32) | c1[j];
+            const unsigned __int128 m = static_cast<unsigned __int128>(x) * span_;
+            out[j] = static_cast<uint64_t>(m) >= threshold_ ? RainStep{lower_ + static_cast<uint64_t>(m >> 64), (c3[j] & 1) != 0}
+                                                            : step(index, hop + j);
+        }
+    }
+
+private:
+    struct Draw {
+        uint64_t value;   // uniform in [0, span)
+        bool     bit;
+    };
+
+    // Counter = (hop, attempt, index lo, index hi). The 64‑bit value is
+    // reduced with Lemire's multiply‑shift; the rare biased draws are
+    // rejected and retried with the next attempt counter.
+    Draw draw(uint64_t index, uint64_t hop) const {
+        for (uint32_t attempt = 0;; ++attempt) {
+            const auto r = Philox4x32::generate(
+                {static_cast<uint32_t>(hop), attempt, static_cast<uint32_t>(index),
+                 static_cast<uint32_t>(index >> 32)},
+                key_);
+            const uint64_t x = (static_cast<uint64_t>(r[0]) << 32) | r[1];
+            const unsigned __int128 m = static_cast<unsigned __int128>(x) * span_;
+            if (static_cast<uint64_t>(m) >= threshold_) {
+                return {static_cast<uint64_t>(m >> 64), (r[3] & 1) != 0};
+            }
+        }
+    }
+
+    Philox4x32::Key key_;
+    uint64_t lower_;
+    uint64_t span_;
+    uint64_t threshold_;   // 2^64 mod span: draws below it are biased
+};
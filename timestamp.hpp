@@ -0,0 +1,42 @@
+// timestamp.hpp
+// Shared by the string, integer and emoji generators.
+// The "[YYYY-mm-dd HH:MM:SS]" stamp only changes once a second, so it
+// is formatted once per second (localtime_r takes the libc timezone
+// lock) and handed out from a per-thread cache in between.
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <chrono>   // For time
+#include <ctime>    // For time formatting
+
+// "[YYYY-mm-dd HH:MM:SS]" for `t` in local time; returns its length.
+inline size_t formatTimestamp(std::time_t t, char* out, size_t size) {
+    std::tm local;
+    localtime_r(&t, &local);   // thread-safe; batches stamp from worker threads
+    return strftime(out, size, "[%Y-%m-%d %H:%M:%S]", &local);
+}
+
+class TimestampCache {
+public:
+    // The stamp for the current second; valid until the next call.
+    std::string_view now() {
+        const std::time_t t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        if (t != second_) {
+            second_ = t;
+            len_ = formatTimestamp(t, buffer_, sizeof(buffer_));
+        }
+        return std::string_view(buffer_, len_);
+    }
+
+private:
+    std::time_t second_ = -1;
+    char buffer_[32];
+    size_t len_ = 0;
+};
+
+// Function to get a formatted timestamp string
+inline std::string getCurrentTimestamp() {
+    thread_local TimestampCache cache;
+    return std::string(cache.now());
+}
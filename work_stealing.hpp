@@ -0,0 +1,112 @@
+// work_stealing.hpp
+// ---------------------------------------------------------------
+// Work‑stealing seed scheduler for the prime rain workers.
+// Seeds [0, count) are cut into small batches and dealt out as one
+// contiguous run per worker deque. A worker pops batches from the
+// front of its own deque; once that is empty it steals from the back
+// of the others, so a thread stuck with hop‑heavy seeds is helped out
+// instead of leaving everyone else idle. Each deque has its own
+// small lock, so an owner only ever contends with a thief.
+// A SharedCursor scheduler has no deques: batches come off one atomic
+// cursor, so its memory does not grow with the count and it can run
+// with no count at all until stop().
+// ---------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct SeedBatch {
+    size_t begin = 0;
+    size_t end   = 0;
+    bool empty() const { return begin >= end; }
+};
+
+struct SharedCursor {};
+
+class SeedScheduler {
+public:
+    SeedScheduler(size_t count, size_t workers, size_t batchSize)
+        : queues_(std::max<size_t>(1, workers)) {
+        batchSize = std::max<size_t>(1, batchSize);
+        for (auto& q : queues_) q.reset(new WorkerQueue);
+
+        const size_t perWorker = (count + queues_.size() - 1) / queues_.size();
+        for (size_t w = 0; w < queues_.size(); ++w) {
+            const size_t start = std::min(count, w * perWorker);
+            const size_t stop  = std::min(count, start + perWorker);
+            for (size_t b = start; b < stop; b += batchSize) {
+                queues_[w]->batches.push_back({b, std::min(stop, b + batchSize)});
+            }
+        }
+    }
+
+    // Seeds [0, count) — or 0, 1, 2, … without end if count is 0 — in
+    // batches of `batchSize` off the shared cursor.
+    SeedScheduler(SharedCursor, size_t count, size_t batchSize)
+        : shared_(true), limit_(count), batchSize_(std::max<size_t>(1, batchSize)) {}
+
+    // Next batch for `worker`: its own deque first, then a steal.
+    // Returns false once every deque is empty, or after stop().
+    bool next(size_t worker, SeedBatch& out, bool* stolen = nullptr) {
+        if (stopped_.load(std::memory_order_relaxed)) return false;
+        if (shared_) {
+            const size_t begin = cursor_.fetch_add(batchSize_, std::memory_order_relaxed);
+            if (limit_ && begin >= limit_) return false;
+            out.begin = begin;
+            out.end   = limit_ ? std::min(limit_, begin + batchSize_) : begin + batchSize_;
+            if (stolen) *stolen = false;
+            return true;
+        }
+        if (popFront(*queues_[worker], out)) {
+            if (stolen) *stolen = false;
+            return true;
+        }
+        for (size_t k = 1; k < queues_.size(); ++k) {
+            if (popBack(*queues_[(worker + k) % queues_.size()], out)) {
+                if (stolen) *stolen = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Hands out no further batches. Batches already taken finish unless
+    // their worker checks stopped() and drops them.
+    void stop() { stopped_.store(true, std::memory_order_relaxed); }
+    bool stopped() const { return stopped_.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) WorkerQueue {
+        std::mutex m;
+        std::deque<SeedBatch> batches;
+    };
+
+    static bool popFront(WorkerQueue& q, SeedBatch& out) {
+        std::lock_guard<std::mutex> lk(q.m);
+        if (q.batches.empty()) return false;
+        out = q.batches.front();
+        q.batches.pop_front();
+        return true;
+    }
+
+    static bool popBack(WorkerQueue& q, SeedBatch& out) {
+        std::lock_guard<std::mutex> lk(q.m);
+        if (q.batches.empty()) return false;
+        out = q.batches.back();
+        q.batches.pop_back();
+        return true;
+    }
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    bool   shared_    = false;
+    size_t limit_     = 0;                              // shared: seed count, 0 = endless
+    size_t batchSize_ = 0;
+    alignas(64) std::atomic<size_t> cursor_{0};         // shared: next seed to hand out
+    std::atomic<bool> stopped_{false};
+};